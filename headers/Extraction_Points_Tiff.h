@@ -5,10 +5,11 @@
 #include <fstream>
 #include <vector>
 #include <algorithm>
-
-struct Point3D {
-    int coordinate_x, coordinate_y, coordinate_z;
-};
+#include "Point3D.h"
+#include "Label_Volume.h"
 
 std::vector<Point3D> extraction_all_white_points(const std::string& filename);
-bool save_points(const std::string& filename, const std::vector<Point3D>& points);
\ No newline at end of file
+bool save_points(const std::string& filename, const std::vector<Point3D>& points);
+
+// Decodifica varias pilas de máscaras con el mismo tamaño de imagen en un único volumen de etiquetas
+bool extraction_label_volume(const std::vector<std::string>& filenames, const std::vector<std::string>& names, LabelVolume& volume);
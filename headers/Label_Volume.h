@@ -0,0 +1,24 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Volumen de etiquetas: 0 es fondo y la etiqueta i + 1 corresponde a names[i]
+struct LabelVolume {
+    int width = 0, height = 0, depth = 0;
+    std::vector<uint8_t> labels;
+    std::vector<std::string> names;
+
+    size_t index(int x, int y, int z) const {
+        return ((size_t)z * height + y) * width + x;
+    }
+
+    uint8_t at(int x, int y, int z) const {
+        if (x < 0 || y < 0 || z < 0 || x >= width || y >= height || z >= depth) {
+            return 0;
+        }
+        return labels[index(x, y, z)];
+    }
+};
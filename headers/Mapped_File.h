@@ -0,0 +1,50 @@
+#pragma once
+
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+// Consejos para el sistema sobre cómo se recorrerá la vista (madvise); en Windows no tienen efecto
+enum class MappedAccess {
+    Sequential,
+    Random,
+    HugePages
+};
+
+class MappedFile {
+    private:
+        void* mapped_data = nullptr;
+        size_t mapped_size = 0;
+#ifdef _WIN32
+        void* file_handle = nullptr;
+        void* mapping_handle = nullptr;
+#else
+        int file_descriptor = -1;
+#endif
+
+    public:
+        MappedFile() = default;
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        MappedFile(MappedFile&& other) noexcept;
+        MappedFile& operator=(MappedFile&& other) noexcept;
+
+        // Un archivo vacío se abre sin error con data() == nullptr y size() == 0
+        bool open_read(const std::string& filename);
+        // Crea (o trunca) el archivo con el tamaño indicado y lo mapea compartido para escritura:
+        // las páginas escritas vuelven al archivo y el sistema puede descartarlas bajo presión de memoria
+        bool open_write(const std::string& filename, size_t size);
+        void advise(MappedAccess access) const;
+        bool flush() const;
+        void close();
+
+        bool is_open() const { return mapped_data != nullptr; }
+        const uint8_t* data() const { return static_cast<const uint8_t*>(mapped_data); }
+        uint8_t* mutable_data() { return static_cast<uint8_t*>(mapped_data); }
+        size_t size() const { return mapped_size; }
+};
+
+uint64_t hash_bytes(const uint8_t* data, size_t size, uint64_t seed = 14695981039346656037ull);
+bool hash_file_contents(const std::string& filename, uint64_t& hash);
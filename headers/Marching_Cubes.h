@@ -7,7 +7,20 @@
 #include <unordered_map>
 #include <cmath>
 #include <array>
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
 #include <glm/glm.hpp>
+#include "Point3D.h"
+#include "Label_Volume.h"
+#include "Mapped_File.h"
+#include "Mesh_Buffers.h"
+#include "Mesh_Arena.h"
+#include "Mesh_Export.h"
+#include "Mesh_Simplification.h"
+#include "Mesh_Optimization.h"
+#include "Mesh_Smoothing.h"
+#include "Mesh_Components.h"
 
 struct Point3DMC {
     float x, y, z;
@@ -45,20 +58,91 @@ struct Point3DMC {
     }
 };
 
-struct Point3DMCHash {
-    size_t operator() (const Point3DMC& point) const {
-        int x = static_cast<int>(point.x * 1000000);
-        int y = static_cast<int>(point.y * 1000000);
-        int z = static_cast<int>(point.z * 1000000);
-        return std::hash<int>()(x) ^ (std::hash<int>()(y) << 1) ^ (std::hash<int>()(z) << 2);
-    }
+enum class MeshingMode {
+    MarchingCubes,
+    SurfaceNets,
+    DualContouring,
+    Adaptive
+};
+
+enum class NormalMode {
+    Face,
+    Gradient
+};
+
+// Orden del campo escalar en memoria: capas Z completas o bricks de 8x8x8 muestras contiguas
+enum class FieldLayout {
+    Linear,
+    Bricked
+};
+
+const int field_brick_size = 8;
+
+// Posición de una muestra en el orden por bricks: brick en orden lineal y dentro de él x, y, z
+inline size_t brick_field_offset(int x, int y, int z, int bricks_x, int bricks_y) {
+    size_t brick = ((size_t)(z >> 3) * bricks_y + (y >> 3)) * bricks_x + (x >> 3);
+    return brick * 512 + (size_t)(((z & 7) << 6) | ((y & 7) << 3) | (x & 7));
+}
+
+struct MeshData {
+    float iso_level;
+    std::string label;
+    MeshBuffers buffers;
+    std::vector<uint64_t> vertex_keys;
+    std::vector<uint32_t> layer_triangles;
+    MeshArena arena;
+    bool optimized;
+    // Con salida mapeada la malla queda solo en este .rmesh y buffers está vacío
+    std::string mapped_file;
+    size_t mapped_vertices = 0;
+    size_t mapped_triangles = 0;
+
+    MeshData(float iso_level = 0.5f) : iso_level(iso_level), optimized(false) {}
+};
+
+struct FieldCacheHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t data_offset;
+    uint64_t input_hash;
+    float cell_size;
+    float influence_radius;
+    float kernel_sigma;
+    int32_t grid_size_x, grid_size_y, grid_size_z;
+    float min_bounds[3];
+    float max_bounds[3];
+    uint32_t field_layout;
 };
 
-struct Triangle {
-    std::array<int, 3> vertexes_index;
-    Point3DMC normalize;
+// Estado del modo incremental: hash de cada corte y mallas con sus claves y el primer triángulo de cada capa Z
+struct IncrementalStateHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t level_count;
+    uint32_t slice_count;
+    uint32_t normal_mode;
+    uint64_t input_hash;
+    float cell_size;
+    float influence_radius;
+    int32_t grid_size_x, grid_size_y, grid_size_z;
+    float min_bounds[3];
 };
 
+struct IncrementalLevelHeader {
+    float iso_level;
+    uint32_t reserved;
+    uint64_t vertex_count;
+    uint64_t index_count;
+    uint64_t layer_count;
+};
+
+const uint32_t incremental_state_version = 1;
+const uint32_t field_cache_version = 2;
+const uint32_t field_cache_data_offset = 128;
+static_assert(sizeof(FieldCacheHeader) <= field_cache_data_offset, "FieldCacheHeader must fit before the field data");
+
+class SpatialHash;
+
 struct GridCell {
     Point3DMC point[8];
     float value[8];
@@ -67,38 +151,154 @@ struct GridCell {
 class MarchingCubes {
     private:
         std::vector<Point3DMC> point_cloud;
-        std::vector<Triangle> triangles;
-
-        std::vector<Point3DMC> unique_vertices;
-        std::vector<Point3DMC> vertex_normals;
-        std::unordered_map<Point3DMC, int, Point3DMCHash> vertex_map;
+        std::vector<MeshData> meshes;
 
         int grid_size_x, grid_size_y, grid_size_z;
         float cell_size;
         Point3DMC min_bounds, max_bounds;
-        std::vector<std::vector<std::vector<float>>> scalar_field;
+        float influence_radius;
+        std::vector<float> scalar_field;
+        MappedFile field_cache_file;
+        const float* field_values = nullptr;
+        std::string cache_directory;
+
+        // field_index numera las muestras para las claves de los vértices; field_offset es su posición en memoria
+        size_t field_index(int x, int y, int z) const {
+            return ((size_t)z * grid_size_y + y) * grid_size_x + x;
+        }
+        template <FieldLayout layout>
+        size_t field_offset_as(int x, int y, int z) const {
+            if (layout == FieldLayout::Linear) {
+                return field_index(x, y, z);
+            }
+            return brick_field_offset(x, y, z, (grid_size_x + 7) >> 3, (grid_size_y + 7) >> 3);
+        }
+        size_t field_offset(int x, int y, int z) const {
+            if (field_layout == FieldLayout::Linear) {
+                return field_offset_as<FieldLayout::Linear>(x, y, z);
+            }
+            return field_offset_as<FieldLayout::Bricked>(x, y, z);
+        }
+        size_t field_storage_size() const;
+
+        // Recorre [0, nx) x [0, ny) x [z_begin, z_end) por bloques: capa por capa o, con by_bricks,
+        // de a 8x8x8 para que las muestras que se leen juntas queden en las mismas páginas
+        template <typename Visit>
+        void for_each_field_block(int nx, int ny, int z_begin, int z_end, bool by_bricks, Visit visit) const {
+            if (!by_bricks) {
+                for (int z = z_begin; z < z_end; z++) {
+                    visit(0, nx, 0, ny, z, z + 1);
+                }
+                return;
+            }
+            for (int z0 = z_begin; z0 < z_end; z0 = (z0 & ~7) + field_brick_size) {
+                int z1 = std::min((z0 & ~7) + field_brick_size, z_end);
+                for (int y0 = 0; y0 < ny; y0 += field_brick_size) {
+                    for (int x0 = 0; x0 < nx; x0 += field_brick_size) {
+                        visit(x0, std::min(x0 + field_brick_size, nx), y0, std::min(y0 + field_brick_size, ny), z0, z1);
+                    }
+                }
+            }
+        }
+        void pad_bounds();
+        void size_grid_to_bounds();
+        bool matches_field_cache(const FieldCacheHeader& header, uint64_t input_hash) const;
+        void prepare_scalar_field(const std::string& cache_name, uint64_t input_hash, const std::vector<float>& iso_levels);
+        float field_value_at(SpatialHash& spatial_hash, int i, int j, int k) const;
+        void calculate_field_layers(float* field, int first_layer, int last_layer);
+        void calculate_adaptive_field(float* field, const std::vector<float>& iso_levels);
+        void fill_scalar_field(float* field, const std::vector<float>& iso_levels);
+        FieldCacheHeader field_cache_header(uint64_t input_hash) const;
+        bool calculate_mapped_field(const std::string& cache_file, uint64_t input_hash, const std::vector<float>& iso_levels);
+        bool store_mapped_mesh(MeshData& mesh, const std::string& filename);
+        bool save_incremental_state(const std::string& state_file, const std::vector<uint64_t>& slice_hashes, uint64_t input_hash) const;
+        bool load_incremental_state(const std::string& state_file, const std::vector<float>& iso_levels,
+                                    std::vector<uint64_t>& slice_hashes, uint64_t& input_hash);
+        void remesh_layers(const std::vector<uint8_t>& dirty_cells, const std::vector<uint8_t>& changed_layers);
 
-        int add_or_find_vertex(const Point3DMC& vertex);
-        void calculate_vertex_normals();
+        NormalMode normal_mode = NormalMode::Face;
+        MeshingMode meshing_mode = MeshingMode::MarchingCubes;
+        FieldLayout field_layout = FieldLayout::Linear;
+        // Campo respaldado por su archivo de caché mapeado; las mallas terminadas se escriben a través de un .rmesh mapeado
+        bool mapped_storage = false;
+        std::vector<std::string> mapped_mesh_files;
+
+        template <FieldLayout layout, bool interior>
+        float field_sample(int x, int y, int z) const;
+        template <NormalMode normals, FieldLayout layout, bool interior>
+        void process_cube_kernel(int x, int y, int z);
+        template <NormalMode normals, FieldLayout layout>
+        void march_row_kernel(int x_begin, int x_end, int y, int z);
+        void march_row(int x_begin, int x_end, int y, int z);
+        uint32_t add_or_find_vertex(MeshData& mesh, uint64_t key, const Point3DMC& vertex, const Point3DMC& normal);
+        uint64_t edge_vertex_key(int x, int y, int z, int edge, float mu) const;
+        size_t estimate_active_cells(float iso_level);
+        float interpolation_factor(float value_1, float value_2, float iso_level) const;
+        bool dual_cell_vertex(int x, int y, int z, float iso_level, float position[3], float normal[3]);
+        void generate_dual_mesh(MeshData& mesh);
+        void contour_dual_edges(MeshData& mesh, const std::vector<uint32_t>& cell_vertex);
+        void generate_adaptive_mesh(MeshData& mesh);
+        float adaptive_tolerance = 0.1f;
+        int adaptive_depth = 4;
+        void process_label_cell(int x, int y, int z, const uint8_t labels[8], int stride);
         float vertex_tolerance = 1e-6f;
+
+        // Rango de capas de celdas que recorre generate_mesh (-1 = hasta el final) y claves para el modo por bloques
+        int active_z_begin = 0;
+        int active_z_end = -1;
+        bool keep_vertex_keys = false;
+        // El modo incremental necesita los triángulos agrupados por capa Z aunque el campo esté por bricks
+        bool keep_layer_order = false;
     
     public:
         MarchingCubes(float cell_size = 1.0f);
 
         bool load_points_cloud(const std::string& file_cloud);
+        void set_points(const Point3D* points, size_t count);
         void calculate_bounds();
         void initialize_grid();
-        void calculate_scalar_field();
+        void calculate_scalar_field(const std::vector<float>& iso_levels = {});
+        void set_cache_directory(const std::string& directory);
+        bool load_field_cache(const std::string& cache_file, uint64_t input_hash);
+        bool save_field_cache(const std::string& cache_file, uint64_t input_hash) const;
         Point3DMC vertex_interpolation(const Point3DMC& point_1, const Point3DMC& point2, float value_1, float value_2, float iso_level);
         Point3DMC get_grid_point(int x, int y, int z);
         float get_scalar_value(int x, int y, int z);
-        void process_cube(int x, int y, int z, float iso_level);
+        Point3DMC get_gradient(int x, int y, int z);
+        void set_normal_mode(NormalMode mode);
+        void set_kernel_radius_factor(float factor);
+        void set_meshing_mode(MeshingMode mode);
+        void set_field_layout(FieldLayout layout);
+        void set_mapped_storage(bool enabled);
+        void set_mapped_output(const std::vector<std::string>& mesh_files);
+        void set_adaptive_tolerance(float tolerance);
+        void set_adaptive_depth(int depth);
+        void process_cube(int x, int y, int z);
         void generate_mesh(float iso_level = 0.5f);
+        void generate_mesh(const std::vector<float>& iso_levels);
         void process_point_cloud(const std::string& filename, float iso_level = 0.5f);
-        const std::vector<Triangle>& get_triangles() const;
-        const std::vector<Point3DMC>& get_unique_vertices() const;
-        const std::vector<Point3DMC>& get_vertex_normals() const;
-        void export_file_obj(const std::string& fileobj);
+        void process_point_cloud(const std::string& filename, const std::vector<float>& iso_levels);
+        void process_points(const Point3D* points, size_t count, const std::vector<float>& iso_levels, const std::string& cache_name = "");
+        void process_points_incremental(const Point3D* points, size_t count, const std::vector<float>& iso_levels, const std::string& state_name);
+        void process_label_volume(const LabelVolume& volume, int stride = 1);
+        bool process_point_cloud_chunked(const std::string& file_cloud, const std::vector<float>& iso_levels,
+                                         size_t memory_budget, const std::vector<std::string>& chunk_files,
+                                         int slab_index = 0, int slab_count = 1);
+        size_t get_mesh_count() const;
+        float get_iso_level(size_t level = 0) const;
+        const std::string& get_label(size_t level = 0) const;
+        const std::string& get_mapped_file(size_t level = 0) const;
+        const MeshBuffers& get_mesh(size_t level = 0) const;
+        MeshBuffers take_mesh(size_t level = 0);
+        void filter_components(size_t min_triangles, size_t level = 0);
+        void smooth_mesh(int iterations, size_t level = 0);
+        void decimate_mesh(const SimplificationOptions& options, size_t level = 0);
+        void optimize_mesh(size_t level = 0);
+        void export_file_obj(const std::string& fileobj, size_t level = 0);
+        void export_file_ply(const std::string& fileply, size_t level = 0);
+        void export_file_native(const std::string& filemesh, bool with_meshlets = false, size_t level = 0);
+        void export_file_compressed(const std::string& filemesh, int normal_bits = 16, size_t level = 0);
+        void export_file_lod(const std::string& filelod, const std::vector<float>& ratios, size_t level = 0);
         void clear_mesh();
         void print_mesh_stats() const;
 };
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <algorithm>
+#include "Mesh_Buffers.h"
+
+// Bloques de tamaño fijo que nunca se realocan; cada elemento ocupa Stride valores
+template <typename T, size_t Stride>
+class ChunkedBuffer {
+    private:
+        std::vector<std::unique_ptr<T[]>> blocks;
+        size_t items_per_block;
+        size_t items_in_last = 0;
+        size_t total_items = 0;
+
+    public:
+        ChunkedBuffer(size_t items_per_block = 1 << 15) : items_per_block(items_per_block) {}
+
+        void set_items_per_block(size_t items) {
+            if (blocks.empty()) {
+                items_per_block = std::max<size_t>(items, 1024);
+            }
+        }
+
+        T* allocate() {
+            if (blocks.empty() || items_in_last == items_per_block) {
+                blocks.emplace_back(new T[items_per_block * Stride]);
+                items_in_last = 0;
+            }
+            T* item = blocks.back().get() + items_in_last * Stride;
+            items_in_last++;
+            total_items++;
+            return item;
+        }
+
+        size_t size() const { return total_items; }
+
+        void copy_to(T* destination) const {
+            for (size_t b = 0; b < blocks.size(); b++) {
+                size_t items = (b + 1 == blocks.size()) ? items_in_last : items_per_block;
+                std::memcpy(destination, blocks[b].get(), items * Stride * sizeof(T));
+                destination += items * Stride;
+            }
+        }
+
+        void clear() {
+            blocks.clear();
+            items_in_last = 0;
+            total_items = 0;
+        }
+};
+
+// Tabla hash de direccionamiento abierto: clave de arista de la malla -> índice de vértice
+class VertexLookup {
+    private:
+        static constexpr uint64_t empty_key = ~0ull;
+        std::vector<uint64_t> keys;
+        std::vector<uint32_t> values;
+        size_t mask = 0;
+        size_t count = 0;
+
+        size_t slot_for(uint64_t key) const {
+            return (size_t)((key * 0x9E3779B97F4A7C15ull) >> 17) & mask;
+        }
+        void grow();
+
+    public:
+        void reserve(size_t expected);
+        bool find_or_insert(uint64_t key, uint32_t value, uint32_t& found);
+        bool find(uint64_t key, uint32_t& found) const;
+        // Clave de cada valor insertado: keys_by_value[valor] = clave
+        void keys_by_value(std::vector<uint64_t>& result) const;
+        size_t size() const { return count; }
+        void clear();
+};
+
+struct MeshArena {
+    ChunkedBuffer<float, 3> positions;
+    ChunkedBuffer<float, 3> normals;
+    ChunkedBuffer<uint32_t, 3> triangles;
+    VertexLookup lookup;
+
+    void reserve(size_t expected_vertices, size_t expected_triangles);
+    uint32_t add_vertex(const float position[3], const float normal[3]);
+    void add_triangle(uint32_t a, uint32_t b, uint32_t c);
+    void flatten_into(MeshBuffers& buffers);
+    void clear();
+};
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+struct MeshBuffers {
+    std::vector<float> positions;
+    std::vector<float> normals;
+    std::vector<uint32_t> indices;
+
+    size_t vertex_count() const { return positions.size() / 3; }
+    size_t triangle_count() const { return indices.size() / 3; }
+    bool empty() const { return indices.empty(); }
+
+    void clear();
+    void reserve(size_t vertices, size_t triangles);
+    uint32_t add_vertex(float x, float y, float z, float normal_x = 0.0f, float normal_y = 0.0f, float normal_z = 0.0f);
+    void add_triangle(uint32_t a, uint32_t b, uint32_t c);
+
+    void compute_bounds(float min_bounds[3], float max_bounds[3]) const;
+    std::vector<float> compute_face_normals() const;
+    void compute_vertex_normals();
+    size_t memory_bytes() const;
+
+    std::vector<float> take_positions();
+    std::vector<float> take_normals();
+    std::vector<uint32_t> take_indices();
+};
+
+// Las mismas operaciones sobre arreglos crudos, para mallas que viven fuera de MeshBuffers (un .rmesh mapeado)
+void compute_bounds(const float* positions, size_t vertex_count, float min_bounds[3], float max_bounds[3]);
+void compute_vertex_normals(const float* positions, size_t vertex_count, const uint32_t* indices, size_t index_count, float* normals);
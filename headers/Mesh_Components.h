@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include "Mesh_Buffers.h"
+
+struct ComponentStats {
+    size_t component_count = 0;
+    size_t kept_components = 0;
+    size_t removed_triangles = 0;
+    size_t removed_vertices = 0;
+    // Triángulos por componente, de mayor a menor
+    std::vector<size_t> triangle_counts;
+};
+
+// Componentes conexas por union-find en paralelo; se descartan las de menos de min_triangles triángulos
+void remove_small_components(MeshBuffers& mesh, size_t min_triangles, ComponentStats* stats = nullptr);
@@ -0,0 +1,170 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <cstdint>
+#include "Mesh_Buffers.h"
+#include "Mapped_File.h"
+#include "Mesh_Simplification.h"
+#include "Mesh_Meshlets.h"
+
+struct NativeMeshHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t header_size;
+    uint64_t vertex_count;
+    uint64_t index_count;
+    float min_bounds[3];
+    float max_bounds[3];
+    uint64_t positions_offset;
+    uint64_t normals_offset;
+    uint64_t indices_offset;
+    uint64_t file_size;
+    // Versión 2: meshlets opcionales junto al buffer de índices
+    uint64_t meshlet_count;
+    uint64_t meshlet_vertex_count;
+    uint64_t meshlet_triangle_count;
+    uint64_t meshlets_offset;
+    uint64_t meshlet_vertices_offset;
+    uint64_t meshlet_triangles_offset;
+};
+
+struct LodFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t level_count;
+    float min_bounds[3];
+    float max_bounds[3];
+    uint64_t levels_offset;
+    uint64_t file_size;
+};
+
+struct LodLevelEntry {
+    uint64_t vertex_count;
+    uint64_t index_count;
+    float triangle_ratio;
+    float geometric_error;
+    uint64_t positions_offset;
+    uint64_t normals_offset;
+    uint64_t indices_offset;
+};
+
+struct CompressedMeshHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t header_size;
+    uint64_t vertex_count;
+    uint64_t index_count;
+    float min_bounds[3];
+    float max_bounds[3];
+    uint32_t normal_bits;
+    uint32_t vertex_block_count;
+    uint32_t index_block_count;
+    uint32_t reserved;
+    uint64_t blocks_offset;
+    uint64_t file_size;
+};
+
+// Cada bloque se decodifica de forma independiente: first/count son vértices o índices según el tipo
+struct CompressedBlockEntry {
+    uint64_t offset;
+    uint64_t size;
+    uint64_t first;
+    uint64_t count;
+};
+
+// Contenedor .rchunk: cabecera y luego un registro por bloque con sus vértices, claves de arista e índices
+struct ChunkedMeshHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t chunk_count;
+    uint64_t vertex_count;
+    uint64_t index_count;
+};
+
+struct ChunkRecordHeader {
+    uint64_t vertex_count;
+    uint64_t index_count;
+};
+
+const uint32_t native_mesh_version = 2;
+const uint32_t lod_file_version = 1;
+const uint32_t compressed_mesh_version = 1;
+const uint32_t chunked_mesh_version = 1;
+const size_t native_mesh_alignment = 64;
+const size_t compressed_block_vertices = 16384;
+const size_t compressed_block_indices = 16384 * 3;
+
+bool write_mesh_obj(const std::string& filename, const MeshBuffers& mesh);
+bool write_mesh_ply(const std::string& filename, const MeshBuffers& mesh);
+bool write_mesh_native(const std::string& filename, const MeshBuffers& mesh, const MeshletData* meshlets = nullptr);
+// Crea un .rmesh del tamaño justo y lo deja mapeado para llenar sus bloques en el lugar, sin pasar por
+// MeshBuffers; finish_mapped_native_mesh completa los límites de la cabecera y cierra el archivo
+bool create_mapped_native_mesh(const std::string& filename, size_t vertex_count, size_t index_count, MappedFile& file);
+bool finish_mapped_native_mesh(MappedFile& file);
+bool write_mesh_lod(const std::string& filename, const std::vector<LodLevel>& levels);
+
+// Posiciones cuantizadas a 16 bits en la caja de la malla, normales octaédricas de 8 o 16 bits
+// e índices codificados como diferencias zigzag/varint
+bool write_mesh_compressed(const std::string& filename, const MeshBuffers& mesh, int normal_bits = 16);
+bool read_mesh_compressed(const std::string& filename, MeshBuffers& mesh);
+
+// Escribe los bloques de una malla generada por partes; cada vértice lleva su clave global de arista
+class ChunkedMeshWriter {
+    private:
+        std::ofstream file;
+        ChunkedMeshHeader header = {};
+
+    public:
+        bool open(const std::string& filename);
+        bool write_chunk(const MeshBuffers& mesh, const std::vector<uint64_t>& vertex_keys);
+        bool close();
+};
+
+// Une los vértices repetidos entre bloques consecutivos por su clave y escribe un .obj bloque a bloque,
+// sin cargar la malla completa en memoria. Varios contenedores se leen en orden como uno solo
+bool weld_chunked_mesh(const std::vector<std::string>& chunk_files, const std::string& obj_file);
+
+// Vista de solo lectura sobre un archivo .rmesh mapeado en memoria
+class NativeMeshView {
+    private:
+        MappedFile file;
+        NativeMeshHeader header = {};
+
+    public:
+        bool open(const std::string& filename);
+
+        const NativeMeshHeader& get_header() const { return header; }
+        size_t vertex_count() const { return (size_t)header.vertex_count; }
+        size_t index_count() const { return (size_t)header.index_count; }
+        const float* positions() const { return reinterpret_cast<const float*>(file.data() + header.positions_offset); }
+        const float* normals() const { return reinterpret_cast<const float*>(file.data() + header.normals_offset); }
+        const uint32_t* indices() const { return reinterpret_cast<const uint32_t*>(file.data() + header.indices_offset); }
+
+        size_t meshlet_count() const { return (size_t)header.meshlet_count; }
+        const Meshlet* meshlets() const { return reinterpret_cast<const Meshlet*>(file.data() + header.meshlets_offset); }
+        const uint32_t* meshlet_vertices() const { return reinterpret_cast<const uint32_t*>(file.data() + header.meshlet_vertices_offset); }
+        const uint8_t* meshlet_triangles() const { return file.data() + header.meshlet_triangles_offset; }
+};
+
+// Vista de solo lectura sobre un archivo .rlod con varios niveles de detalle
+class LodMeshView {
+    private:
+        MappedFile file;
+        LodFileHeader header = {};
+        const LodLevelEntry* entries = nullptr;
+
+    public:
+        bool open(const std::string& filename);
+
+        const LodFileHeader& get_header() const { return header; }
+        size_t level_count() const { return header.level_count; }
+        const LodLevelEntry& level(size_t index) const { return entries[index]; }
+        const float* positions(size_t index) const { return reinterpret_cast<const float*>(file.data() + entries[index].positions_offset); }
+        const float* normals(size_t index) const { return reinterpret_cast<const float*>(file.data() + entries[index].normals_offset); }
+        const uint32_t* indices(size_t index) const { return reinterpret_cast<const uint32_t*>(file.data() + entries[index].indices_offset); }
+
+        // Nivel más simple cuyo error proyectado no supera max_pixel_error
+        size_t select_level(float pixels_per_unit, float max_pixel_error) const;
+};
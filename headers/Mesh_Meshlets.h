@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Mesh_Buffers.h"
+
+const size_t meshlet_max_vertices = 64;
+const size_t meshlet_max_triangles = 124;
+
+// Un meshlet se descarta por orientación si, con la cámara en c:
+// dot(center - c, cone_axis) >= cone_cutoff * length(center - c) + radius
+struct Meshlet {
+    uint32_t vertex_offset;
+    uint32_t vertex_count;
+    uint32_t triangle_offset;
+    uint32_t triangle_count;
+    float center[3];
+    float radius;
+    float cone_axis[3];
+    float cone_cutoff;
+};
+
+// Los triángulos usan índices locales de 8 bits sobre los vértices de su meshlet
+struct MeshletData {
+    std::vector<Meshlet> meshlets;
+    std::vector<uint32_t> vertices;
+    std::vector<uint8_t> triangles;
+
+    bool empty() const { return meshlets.empty(); }
+};
+
+MeshletData build_meshlets(const MeshBuffers& mesh, size_t max_vertices = meshlet_max_vertices, size_t max_triangles = meshlet_max_triangles);
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Mesh_Buffers.h"
+
+// Reordenamiento de triángulos para la caché de vértices post-transformación (Forsyth)
+void optimize_vertex_cache(std::vector<uint32_t>& indices, size_t vertex_count);
+
+// Agrupa los triángulos en clusters y dibuja primero los que miran hacia afuera
+void optimize_overdraw(std::vector<uint32_t>& indices, const std::vector<float>& positions, size_t vertex_count, float threshold = 1.05f);
+
+// Renumera los vértices en orden de primer uso para mejorar la localidad de lectura
+void optimize_vertex_fetch(MeshBuffers& mesh);
+
+// Promedio de fallos de caché por triángulo con una caché FIFO
+double average_cache_miss_ratio(const std::vector<uint32_t>& indices, size_t vertex_count, size_t cache_size = 16);
+
+// Las tres pasadas en orden: caché de vértices, overdraw y lectura de vértices
+void optimize_mesh(MeshBuffers& mesh);
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include "Mesh_Buffers.h"
+
+struct SimplificationOptions {
+    size_t target_triangles = 0;
+    double max_error = 0.0;
+    bool preserve_boundary = true;
+};
+
+struct SimplificationStats {
+    size_t input_triangles = 0;
+    size_t output_triangles = 0;
+    size_t collapses = 0;
+    double max_error = 0.0;
+};
+
+// Colapso de aristas por error cuadrático (Garland-Heckbert)
+MeshBuffers simplify_mesh(const MeshBuffers& mesh, const SimplificationOptions& options, SimplificationStats* stats = nullptr);
+
+struct LodLevel {
+    float triangle_ratio;
+    float geometric_error;
+    MeshBuffers mesh;
+};
+
+// Cada nivel se simplifica a partir del anterior; el error geométrico se acumula
+std::vector<LodLevel> build_lod_chain(const MeshBuffers& mesh, const std::vector<float>& ratios);
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Mesh_Buffers.h"
+
+// Vecinos únicos de cada vértice en formato CSR: neighbors[offsets[v], offsets[v + 1])
+struct VertexAdjacency {
+    std::vector<uint32_t> offsets;
+    std::vector<uint32_t> neighbors;
+
+    void build(const MeshBuffers& mesh);
+};
+
+// Suavizado de Taubin: pasos alternados lambda (contrae) y mu (expande) que conservan el volumen
+void smooth_mesh_taubin(MeshBuffers& mesh, int iterations, float lambda = 0.5f, float mu = -0.53f);
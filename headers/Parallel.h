@@ -0,0 +1,42 @@
+#pragma once
+
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+
+inline unsigned int worker_count() {
+    unsigned int count = std::thread::hardware_concurrency();
+    return count == 0 ? 1 : count;
+}
+
+// Divide [begin, end) en rangos contiguos y ejecuta function(inicio, fin, hilo) en paralelo
+template <typename Function>
+void parallel_for(size_t begin, size_t end, Function function, size_t min_per_thread = 1024) {
+    if (end <= begin) {
+        return;
+    }
+
+    size_t total = end - begin;
+    size_t threads = std::min<size_t>(worker_count(), (total + min_per_thread - 1) / min_per_thread);
+    if (threads <= 1) {
+        function(begin, end, (size_t)0);
+        return;
+    }
+
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+    size_t step = (total + threads - 1) / threads;
+    for (size_t t = 1; t < threads; t++) {
+        size_t range_begin = begin + t * step;
+        size_t range_end = std::min(end, range_begin + step);
+        if (range_begin < range_end) {
+            workers.emplace_back(function, range_begin, range_end, t);
+        }
+    }
+
+    function(begin, std::min(end, begin + step), (size_t)0);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
@@ -0,0 +1,5 @@
+#pragma once
+
+struct Point3D {
+    int coordinate_x, coordinate_y, coordinate_z;
+};
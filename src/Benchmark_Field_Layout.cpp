@@ -0,0 +1,123 @@
+#include "../headers/Marching_Cubes.h"
+#include <chrono>
+#include <iomanip>
+
+// Compara el campo escalar por capas Z con el campo por bricks de 8x8x8 en grillas crecientes.
+// Cada medición llena el campo y luego lee las 8 esquinas de todas las celdas como process_cube,
+// recorriendo capa por capa (lineal) o brick por brick (bricks)
+
+struct LayoutTiming {
+    double fill_ms;
+    double march_ms;
+    size_t active_cells;
+};
+
+static LayoutTiming run_layout(int size, bool bricked) {
+    int bricks = (size + 7) >> 3;
+    size_t storage = bricked ? (size_t)bricks * bricks * bricks * 512 : (size_t)size * size * size;
+    std::vector<float> field(storage, 0.0f);
+
+    auto offset = [&](int x, int y, int z) {
+        if (bricked) {
+            return brick_field_offset(x, y, z, bricks, bricks);
+        }
+        return ((size_t)z * size + y) * size + x;
+    };
+
+    // Recorre [0, n)^3 de a una capa o de a un brick, igual que MarchingCubes::for_each_field_block
+    auto for_each_block = [&](int n, auto visit) {
+        int step = bricked ? field_brick_size : n;
+        for (int z0 = 0; z0 < n; z0 += bricked ? field_brick_size : 1) {
+            int z1 = bricked ? std::min(z0 + field_brick_size, n) : z0 + 1;
+            for (int y0 = 0; y0 < n; y0 += step) {
+                for (int x0 = 0; x0 < n; x0 += step) {
+                    visit(x0, std::min(x0 + step, n), y0, std::min(y0 + step, n), z0, z1);
+                }
+            }
+        }
+    };
+
+    // Una esfera de radio size/3: el campo vale 1 en el centro y cruza 0.5 en la superficie
+    float center = size * 0.5f;
+    float radius = size / 3.0f;
+    auto start = std::chrono::steady_clock::now();
+    for_each_block(size, [&](int x0, int x1, int y0, int y1, int z0, int z1) {
+        for (int z = z0; z < z1; z++) {
+            for (int y = y0; y < y1; y++) {
+                for (int x = x0; x < x1; x++) {
+                    float dx = x - center, dy = y - center, dz = z - center;
+                    field[offset(x, y, z)] = std::exp(-(dx * dx + dy * dy + dz * dz) / (2.0f * radius * radius) * 1.386f);
+                }
+            }
+        }
+    });
+    auto filled = std::chrono::steady_clock::now();
+
+    size_t active_cells = 0;
+    for_each_block(size - 1, [&](int x0, int x1, int y0, int y1, int z0, int z1) {
+        for (int z = z0; z < z1; z++) {
+            for (int y = y0; y < y1; y++) {
+                for (int x = x0; x < x1; x++) {
+                    int cube_index = 0;
+                    for (int i = 0; i < 8; i++) {
+                        float value = field[offset(x + (i & 1), y + ((i >> 1) & 1), z + (i >> 2))];
+                        if (value < 0.5f) {
+                            cube_index |= 1 << i;
+                        }
+                    }
+                    active_cells += cube_index != 0 && cube_index != 255;
+                }
+            }
+        }
+    });
+    auto marched = std::chrono::steady_clock::now();
+
+    LayoutTiming timing;
+    timing.fill_ms = std::chrono::duration<double, std::milli>(filled - start).count();
+    timing.march_ms = std::chrono::duration<double, std::milli>(marched - filled).count();
+    timing.active_cells = active_cells;
+    return timing;
+}
+
+int main(int argc, char* argv[]) {
+    int max_size = argc > 1 ? std::atoi(argv[1]) : 384;
+    int repeats = argc > 2 ? std::atoi(argv[2]) : 3;
+
+    std::cout << std::setw(6) << "size" << std::setw(12) << "MB"
+              << std::setw(14) << "fill linear" << std::setw(14) << "fill bricked"
+              << std::setw(14) << "march linear" << std::setw(15) << "march bricked" << std::setw(10) << "speedup" << std::endl;
+
+    int crossover = 0;
+    for (int size = 32; size <= max_size; size += size < 128 ? 32 : 64) {
+        LayoutTiming best[2];
+        for (int layout = 0; layout < 2; layout++) {
+            for (int r = 0; r < repeats; r++) {
+                LayoutTiming timing = run_layout(size, layout == 1);
+                if (r == 0 || timing.march_ms < best[layout].march_ms) {
+                    best[layout] = timing;
+                }
+            }
+        }
+        if (best[0].active_cells != best[1].active_cells) {
+            std::cerr << "Error: layouts disagree at size " << size << std::endl;
+            return 1;
+        }
+
+        double speedup = best[0].march_ms / best[1].march_ms;
+        if (speedup > 1.0 && crossover == 0) {
+            crossover = size;
+        }
+        std::cout << std::fixed << std::setprecision(1)
+                  << std::setw(6) << size << std::setw(12) << (double)size * size * size * sizeof(float) / (1 << 20)
+                  << std::setw(14) << best[0].fill_ms << std::setw(14) << best[1].fill_ms
+                  << std::setw(14) << best[0].march_ms << std::setw(15) << best[1].march_ms
+                  << std::setprecision(2) << std::setw(10) << speedup << std::endl;
+    }
+
+    if (crossover > 0) {
+        std::cout << "Bricked layout is faster from " << crossover << "^3 samples" << std::endl;
+    } else {
+        std::cout << "Bricked layout was not faster up to " << max_size << "^3 samples" << std::endl;
+    }
+    return 0;
+}
@@ -1,4 +1,5 @@
 #include "../headers/Extraction_Points_Tiff.h"
+#include "../headers/Parallel.h"
 
 std::vector<Point3D> extraction_all_white_points(const std::string& filename) {
     std::vector<Point3D> points;
@@ -60,4 +61,105 @@ bool save_points(const std::string& filename, const std::vector<Point3D>& points
 
     file.close();
     return true;
-}
\ No newline at end of file
+}
+
+struct DecodedMask {
+    uint32_t width = 0, height = 0;
+    int pages = 0;
+    bool valid = false;
+    std::vector<size_t> voxels;
+};
+
+// Índices de los píxeles no negros de todas las páginas, con la fila invertida como en extraction_all_white_points
+static DecodedMask decode_mask_voxels(const std::string& filename) {
+    DecodedMask mask;
+
+    TIFF* tif = TIFFOpen(filename.c_str(), "r");
+    if (!tif) {
+        std::cerr << "Don't open the TIFF file: " << filename << std::endl;
+        return mask;
+    }
+
+    std::vector<uint32_t> raster;
+    do {
+        uint32_t width, height;
+        TIFFGetField(tif, TIFFTAG_IMAGEWIDTH, &width);
+        TIFFGetField(tif, TIFFTAG_IMAGELENGTH, &height);
+        if (mask.pages == 0) {
+            mask.width = width;
+            mask.height = height;
+        } else if (width != mask.width || height != mask.height) {
+            std::cerr << "Inconsistent page size in " << filename << std::endl;
+            TIFFClose(tif);
+            return mask;
+        }
+
+        raster.resize((size_t)width * height);
+        if (!TIFFReadRGBAImageOriented(tif, width, height, raster.data(), ORIENTATION_TOPLEFT, 0)) {
+            std::cerr << "Error reading image." << std::endl;
+            TIFFClose(tif);
+            return mask;
+        }
+
+        for (uint32_t y = 0; y < height; ++y) {
+            size_t row = ((size_t)mask.pages * height + (height - 1 - y)) * width;
+            for (uint32_t x = 0; x < width; ++x) {
+                uint32_t pixel = raster[(size_t)y * width + x];
+                if (TIFFGetR(pixel) > 0 || TIFFGetG(pixel) > 0 || TIFFGetB(pixel) > 0) {
+                    mask.voxels.push_back(row + x);
+                }
+            }
+        }
+        mask.pages++;
+    } while (TIFFReadDirectory(tif));
+
+    TIFFClose(tif);
+    mask.valid = true;
+    return mask;
+}
+
+bool extraction_label_volume(const std::vector<std::string>& filenames, const std::vector<std::string>& names, LabelVolume& volume) {
+    if (filenames.empty() || filenames.size() > 255 || names.size() != filenames.size()) {
+        std::cerr << "A label volume needs between 1 and 255 named masks." << std::endl;
+        return false;
+    }
+
+    // Cada archivo se decodifica una sola vez y en paralelo con los demás
+    std::vector<DecodedMask> masks(filenames.size());
+    parallel_for(0, filenames.size(), [&](size_t begin, size_t end, size_t) {
+        for (size_t i = begin; i < end; i++) {
+            masks[i] = decode_mask_voxels(filenames[i]);
+        }
+    }, 1);
+
+    volume = LabelVolume();
+    volume.names = names;
+    for (size_t i = 0; i < masks.size(); i++) {
+        if (!masks[i].valid) {
+            return false;
+        }
+        if (i == 0) {
+            volume.width = (int)masks[i].width;
+            volume.height = (int)masks[i].height;
+        } else if ((int)masks[i].width != volume.width || (int)masks[i].height != volume.height) {
+            std::cerr << "Mask " << filenames[i] << " does not share the frame size of " << filenames[0] << std::endl;
+            return false;
+        }
+        volume.depth = std::max(volume.depth, masks[i].pages);
+    }
+
+    // Si dos máscaras se superponen se conserva la etiqueta del primer archivo
+    volume.labels.assign((size_t)volume.width * volume.height * volume.depth, 0);
+    for (size_t i = 0; i < masks.size(); i++) {
+        uint8_t label = (uint8_t)(i + 1);
+        for (size_t voxel : masks[i].voxels) {
+            if (volume.labels[voxel] == 0) {
+                volume.labels[voxel] = label;
+            }
+        }
+    }
+
+    std::cout << "Label volume: " << volume.width << " x " << volume.height << " x " << volume.depth
+              << " with " << masks.size() << " labels" << std::endl;
+    return true;
+}
@@ -0,0 +1,248 @@
+#include "../headers/Mapped_File.h"
+
+#include <utility>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept {
+    *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        close();
+        std::swap(mapped_data, other.mapped_data);
+        std::swap(mapped_size, other.mapped_size);
+#ifdef _WIN32
+        std::swap(file_handle, other.file_handle);
+        std::swap(mapping_handle, other.mapping_handle);
+#else
+        std::swap(file_descriptor, other.file_descriptor);
+#endif
+    }
+    return *this;
+}
+
+#ifdef _WIN32
+
+bool MappedFile::open_read(const std::string& filename) {
+    close();
+
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+                              OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size)) {
+        CloseHandle(file);
+        return false;
+    }
+    // Un archivo vacío no se puede mapear; queda como una vista vacía válida
+    if (file_size.QuadPart == 0) {
+        CloseHandle(file);
+        return true;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!mapping) {
+        CloseHandle(file);
+        return false;
+    }
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    file_handle = file;
+    mapping_handle = mapping;
+    mapped_data = view;
+    mapped_size = (size_t)file_size.QuadPart;
+    return true;
+}
+
+bool MappedFile::open_write(const std::string& filename, size_t size) {
+    close();
+    if (size == 0) {
+        return false;
+    }
+
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, NULL,
+                              CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    // La vista con el tamaño pedido extiende el archivo
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READWRITE, (DWORD)((uint64_t)size >> 32), (DWORD)(size & 0xffffffff), NULL);
+    if (!mapping) {
+        CloseHandle(file);
+        return false;
+    }
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, size);
+    if (!view) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    file_handle = file;
+    mapping_handle = mapping;
+    mapped_data = view;
+    mapped_size = size;
+    return true;
+}
+
+void MappedFile::advise(MappedAccess) const {
+}
+
+bool MappedFile::flush() const {
+    return mapped_data && FlushViewOfFile(mapped_data, 0) && FlushFileBuffers((HANDLE)file_handle);
+}
+
+void MappedFile::close() {
+    if (mapped_data) {
+        UnmapViewOfFile(mapped_data);
+    }
+    if (mapping_handle) {
+        CloseHandle((HANDLE)mapping_handle);
+    }
+    if (file_handle) {
+        CloseHandle((HANDLE)file_handle);
+    }
+    mapped_data = nullptr;
+    mapping_handle = nullptr;
+    file_handle = nullptr;
+    mapped_size = 0;
+}
+
+#else
+
+bool MappedFile::open_read(const std::string& filename) {
+    close();
+
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) != 0) {
+        ::close(fd);
+        return false;
+    }
+    // Un archivo vacío no se puede mapear; queda como una vista vacía válida
+    if (file_stat.st_size == 0) {
+        ::close(fd);
+        return true;
+    }
+
+    void* view = mmap(nullptr, (size_t)file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (view == MAP_FAILED) {
+        ::close(fd);
+        return false;
+    }
+
+    file_descriptor = fd;
+    mapped_data = view;
+    mapped_size = (size_t)file_stat.st_size;
+    return true;
+}
+
+bool MappedFile::open_write(const std::string& filename, size_t size) {
+    close();
+    if (size == 0) {
+        return false;
+    }
+
+    int fd = ::open(filename.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        return false;
+    }
+
+    // ftruncate deja el archivo disperso: solo ocupan disco las páginas que se llegan a escribir
+    if (ftruncate(fd, (off_t)size) != 0) {
+        ::close(fd);
+        return false;
+    }
+
+    void* view = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (view == MAP_FAILED) {
+        ::close(fd);
+        return false;
+    }
+
+    file_descriptor = fd;
+    mapped_data = view;
+    mapped_size = size;
+    return true;
+}
+
+void MappedFile::advise(MappedAccess access) const {
+    if (!mapped_data) {
+        return;
+    }
+    if (access == MappedAccess::Sequential) {
+        madvise(mapped_data, mapped_size, MADV_SEQUENTIAL);
+    } else if (access == MappedAccess::Random) {
+        madvise(mapped_data, mapped_size, MADV_RANDOM);
+    } else {
+#ifdef MADV_HUGEPAGE
+        // Solo tiene efecto donde el núcleo admite páginas grandes en mapeos de archivos
+        madvise(mapped_data, mapped_size, MADV_HUGEPAGE);
+#endif
+    }
+}
+
+bool MappedFile::flush() const {
+    return mapped_data && msync(mapped_data, mapped_size, MS_SYNC) == 0;
+}
+
+void MappedFile::close() {
+    if (mapped_data) {
+        munmap(mapped_data, mapped_size);
+    }
+    if (file_descriptor >= 0) {
+        ::close(file_descriptor);
+    }
+    mapped_data = nullptr;
+    file_descriptor = -1;
+    mapped_size = 0;
+}
+
+#endif
+
+uint64_t hash_bytes(const uint8_t* data, size_t size, uint64_t seed) {
+    // FNV-1a de 64 bits
+    uint64_t hash = seed;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= data[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+bool hash_file_contents(const std::string& filename, uint64_t& hash) {
+    MappedFile file;
+    if (!file.open_read(filename)) {
+        return false;
+    }
+    hash = hash_bytes(file.data(), file.size());
+    return true;
+}
@@ -1,6 +1,12 @@
 #include "../headers/Marching_Cubes.h"
+#include "../headers/Parallel.h"
 
-const int edge_table[256] = {
+#include <Eigen/Dense>
+#include <charconv>
+#include <cstdio>
+#include <limits>
+
+constexpr int edge_table[256] = {
     0x0,   0x109, 0x203, 0x30a, 0x406, 0x50f, 0x605, 0x70c, 0x80c, 0x905, 0xa0f,
     0xb06, 0xc0a, 0xd03, 0xe09, 0xf00, 0x190, 0x99,  0x393, 0x29a, 0x596, 0x49f,
     0x795, 0x69c, 0x99c, 0x895, 0xb9f, 0xa96, 0xd9a, 0xc93, 0xf99, 0xe90, 0x230,
@@ -27,7 +33,7 @@ const int edge_table[256] = {
     0x203, 0x109, 0x0
 };
 
-const int tri_table[256][16] = {
+constexpr int tri_table[256][16] = {
     {-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
     {0, 8, 3, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
     {0, 1, 9, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
@@ -286,40 +292,152 @@ const int tri_table[256][16] = {
     {-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1}
 };
 
-const int edge_index_pairs[12][2] = {
+constexpr int edge_index_pairs[12][2] = {
     {0, 1}, {1, 2}, {2, 3}, {3, 0},
     {4, 5}, {5, 6}, {6, 7}, {7, 4},
     {0, 4}, {1, 5}, {2, 6}, {3, 7}
 };
 
+// Esquina inferior y eje de cada arista del cubo dentro de la malla
+const int edge_grid_offset[12][4] = {
+    {0, 0, 0, 0}, {1, 0, 0, 1}, {0, 1, 0, 0}, {0, 0, 0, 1},
+    {0, 0, 1, 0}, {1, 0, 1, 1}, {0, 1, 1, 0}, {0, 0, 1, 1},
+    {0, 0, 0, 2}, {1, 0, 0, 2}, {1, 1, 0, 2}, {0, 1, 0, 2}
+};
+
 const Point3DMC cube_vertex_offset[8] = {
     Point3DMC(0, 0, 0), Point3DMC(1, 0, 0), Point3DMC(1, 1, 0), Point3DMC(0, 1, 0),
     Point3DMC(0, 0, 1), Point3DMC(1, 0, 1), Point3DMC(1, 1, 1), Point3DMC(0, 1, 1)
 };
 
-MarchingCubes::MarchingCubes(float cell_size) : cell_size(cell_size) {
+static constexpr int cube_corner[8][3] = {
+    {0, 0, 0}, {1, 0, 0}, {1, 1, 0}, {0, 1, 0},
+    {0, 0, 1}, {1, 0, 1}, {1, 1, 1}, {0, 1, 1}
+};
+
+// Cada caso con la lista de sus aristas cortadas y la cantidad de triángulos, para no recorrer
+// los 12 bits de edge_table ni buscar el -1 de tri_table en cada cubo
+struct CubeCase {
+    uint8_t edge_count;
+    uint8_t triangle_count;
+    uint8_t edges[12];
+    uint8_t triangles[15];
+};
+
+static constexpr std::array<CubeCase, 256> build_cube_cases() {
+    std::array<CubeCase, 256> cases = {};
+    for (int c = 0; c < 256; c++) {
+        CubeCase& entry = cases[c];
+        for (int e = 0; e < 12; e++) {
+            if (edge_table[c] & (1 << e)) {
+                entry.edges[entry.edge_count++] = (uint8_t)e;
+            }
+        }
+        int count = 0;
+        while (count < 15 && tri_table[c][count] != -1) {
+            entry.triangles[count] = (uint8_t)tri_table[c][count];
+            count++;
+        }
+        entry.triangle_count = (uint8_t)(count / 3);
+    }
+    return cases;
+}
+
+static constexpr std::array<CubeCase, 256> cube_cases = build_cube_cases();
+static_assert(cube_cases[0].triangle_count == 0 && cube_cases[255].triangle_count == 0, "Empty and full cubes have no triangles");
+static_assert(cube_cases[1].edge_count == 3 && cube_cases[1].triangles[1] == 8, "Cube case table must follow tri_table");
+
+MarchingCubes::MarchingCubes(float cell_size) : cell_size(cell_size), influence_radius(cell_size * 3.0f) {
     grid_size_x = grid_size_y = grid_size_z = 0;
 }
 
+// Interpreta las líneas de [begin, end) como en "iss >> x >> y >> z": se ignoran las líneas sin tres números
+static void parse_xyz_lines(const char* begin, const char* end, std::vector<Point3DMC>& points) {
+    const char* cursor = begin;
+    while (cursor < end) {
+        const char* line_end = static_cast<const char*>(std::memchr(cursor, '\n', (size_t)(end - cursor)));
+        if (line_end == nullptr) {
+            line_end = end;
+        }
+
+        float coordinates[3];
+        int parsed = 0;
+        const char* p = cursor;
+        while (parsed < 3) {
+            while (p < line_end && (*p == ' ' || *p == '\t' || *p == '\r')) {
+                p++;
+            }
+            if (p < line_end && *p == '+') {
+                p++;
+            }
+            auto result = std::from_chars(p, line_end, coordinates[parsed]);
+            if (result.ec != std::errc()) {
+                break;
+            }
+            p = result.ptr;
+            parsed++;
+        }
+        if (parsed == 3) {
+            points.emplace_back(coordinates[0], coordinates[1], coordinates[2]);
+        }
+        cursor = line_end + 1;
+    }
+}
+
+// Agrega a points los puntos del texto [data, data + size)
+static void parse_xyz_text(const char* data, size_t size, std::vector<Point3DMC>& points) {
+    // Bloques de ~1 MB alineados a saltos de línea, cada uno se interpreta en un hilo
+    size_t chunk_count = std::max<size_t>(1, std::min<size_t>(size >> 20, (size_t)worker_count() * 8));
+    std::vector<size_t> chunk_start(chunk_count + 1, size);
+    chunk_start[0] = 0;
+    for (size_t c = 1; c < chunk_count; c++) {
+        size_t position = std::max(c * size / chunk_count, chunk_start[c - 1]);
+        const char* newline = static_cast<const char*>(std::memchr(data + position, '\n', size - position));
+        chunk_start[c] = newline == nullptr ? size : (size_t)(newline - data) + 1;
+    }
+
+    std::vector<std::vector<Point3DMC>> chunk_points(chunk_count);
+    parallel_for(0, chunk_count, [&](size_t begin, size_t end, size_t) {
+        for (size_t c = begin; c < end; c++) {
+            chunk_points[c].reserve((chunk_start[c + 1] - chunk_start[c]) / 8);
+            parse_xyz_lines(data + chunk_start[c], data + chunk_start[c + 1], chunk_points[c]);
+        }
+    }, 1);
+
+    std::vector<size_t> chunk_offset(chunk_count + 1, 0);
+    for (size_t c = 0; c < chunk_count; c++) {
+        chunk_offset[c + 1] = chunk_offset[c] + chunk_points[c].size();
+    }
+
+    size_t first = points.size();
+    points.resize(first + chunk_offset[chunk_count]);
+    parallel_for(0, chunk_count, [&](size_t begin, size_t end, size_t) {
+        for (size_t c = begin; c < end; c++) {
+            std::copy(chunk_points[c].begin(), chunk_points[c].end(), points.begin() + first + chunk_offset[c]);
+        }
+    }, 1);
+}
+
+void MarchingCubes::set_points(const Point3D* points, size_t count) {
+    point_cloud.resize(count);
+    parallel_for(0, count, [&](size_t begin, size_t end, size_t) {
+        for (size_t i = begin; i < end; i++) {
+            point_cloud[i] = Point3DMC((float)points[i].coordinate_x, (float)points[i].coordinate_y, (float)points[i].coordinate_z);
+        }
+    });
+    std::cout << "Loaded " << point_cloud.size() << " points from memory" << std::endl;
+}
+
 bool MarchingCubes::load_points_cloud(const std::string& file_cloud) {
-    std::ifstream file(file_cloud);
-    if (!file.is_open()) {
+    MappedFile file;
+    if (!file.open_read(file_cloud)) {
         std::cerr << "Error opening file: " << file_cloud << std::endl;
         return false;
     }
 
     point_cloud.clear();
-    std::string line;
-
-    while (std::getline(file, line)) {
-        std::istringstream iss(line);
-        float x, y, z;
-        if (iss >> x >> y >> z) {
-            point_cloud.push_back(Point3DMC(x, y, z));
-        }
-    }
+    parse_xyz_text(reinterpret_cast<const char*>(file.data()), file.size(), point_cloud);
 
-    file.close();
     std::cout << "Loaded " << point_cloud.size() << " points from " << file_cloud << std::endl;
     return true;
 }
@@ -340,7 +458,10 @@ void MarchingCubes::calculate_bounds() {
         max_bounds.y = std::max(max_bounds.y, point.y);
         max_bounds.z = std::max(max_bounds.z, point.z);
     }
+    pad_bounds();
+}
 
+void MarchingCubes::pad_bounds() {
     float padding = cell_size * 2;
     min_bounds.x -= padding;
     min_bounds.y -= padding;
@@ -352,119 +473,479 @@ void MarchingCubes::calculate_bounds() {
 
 void MarchingCubes::initialize_grid() {
     calculate_bounds();
+    size_grid_to_bounds();
+}
 
+void MarchingCubes::size_grid_to_bounds() {
     grid_size_x = (int)ceil((max_bounds.x - min_bounds.x) / cell_size) + 1;
     grid_size_y = (int)ceil((max_bounds.y - min_bounds.y) / cell_size) + 1;
     grid_size_z = (int)ceil((max_bounds.z - min_bounds.z) / cell_size) + 1;
 
-    scalar_field.resize(grid_size_x);
-    for (int i = 0; i < grid_size_x; i++) {
-        scalar_field[i].resize(grid_size_y);
-        for (int j = 0; j < grid_size_y; ++j) {
-            scalar_field[i][j].resize(grid_size_z, 0.0f);
-        }
-    }
+    scalar_field.clear();
+    field_cache_file.close();
+    field_values = nullptr;
 
     std::cout << "Grid initialized with dimensions: "
               << grid_size_x << " x " << grid_size_y << " x " << grid_size_z
               << " and cell size: " << cell_size << std::endl;
 }
 
-void MarchingCubes::calculate_scalar_field() {
-    float influence_radius = cell_size * 3.0f;
-    
+void MarchingCubes::calculate_scalar_field(const std::vector<float>& iso_levels) {
+    field_cache_file.close();
+    scalar_field.assign(field_storage_size(), 0.0f);
+    field_values = scalar_field.data();
+    fill_scalar_field(scalar_field.data(), iso_levels);
+}
+
+// Con --mesher=adaptive y niveles iso conocidos el campo se muestrea sobre el octree
+void MarchingCubes::fill_scalar_field(float* field, const std::vector<float>& iso_levels) {
+    if (meshing_mode == MeshingMode::Adaptive && !iso_levels.empty()) {
+        calculate_adaptive_field(field, iso_levels);
+    } else {
+        calculate_field_layers(field, 0, grid_size_z);
+    }
+}
+
+// En el orden por bricks los bordes se completan hasta múltiplos de 8 en los tres ejes
+size_t MarchingCubes::field_storage_size() const {
+    if (field_layout == FieldLayout::Linear) {
+        return (size_t)grid_size_x * grid_size_y * grid_size_z;
+    }
+    size_t bricks = (size_t)((grid_size_x + 7) >> 3) * ((grid_size_y + 7) >> 3) * ((grid_size_z + 7) >> 3);
+    return bricks * 512;
+}
+
+// Suma de los núcleos gaussianos de los puntos que alcanzan la muestra (i, j, k)
+float MarchingCubes::field_value_at(SpatialHash& spatial_hash, int i, int j, int k) const {
+    Point3DMC grid_point(
+        min_bounds.x + i * cell_size,
+        min_bounds.y + j * cell_size,
+        min_bounds.z + k * cell_size
+    );
+
+    float value = 0.0f;
+
+    auto nearby_points = spatial_hash.get_nearby_points(grid_point, influence_radius);
+
+    for (auto* point : nearby_points) {
+        float dx = grid_point.x - point->x;
+        float dy = grid_point.y - point->y;
+        float dz = grid_point.z - point->z;
+        float distance_sq = dx * dx + dy * dy + dz * dz;
+
+        if (distance_sq < influence_radius * influence_radius) {
+            float weight = exp(-distance_sq / (2.0f * cell_size * cell_size));
+            value += weight;
+        }
+    }
+    return value;
+}
+
+// Recalcula las capas Z [first_layer, last_layer) con los puntos que las alcanzan
+void MarchingCubes::calculate_field_layers(float* field, int first_layer, int last_layer) {
+    float z_low = min_bounds.z + first_layer * cell_size - influence_radius;
+    float z_high = min_bounds.z + (last_layer - 1) * cell_size + influence_radius;
     SpatialHash spatial_hash(influence_radius);
     for (auto& point : point_cloud) {
-        spatial_hash.insert(&point);
+        if (point.z >= z_low && point.z <= z_high) {
+            spatial_hash.insert(&point);
+        }
     }
     
-    size_t total_cells = grid_size_x * grid_size_y * grid_size_z;
+    size_t total_cells = (size_t)(last_layer - first_layer) * grid_size_x * grid_size_y;
     std::cout << "Total cells to process: " << total_cells << std::endl;
     
-    size_t progress_step = total_cells / 10;
+    size_t progress_step = std::max<size_t>(total_cells / 10, 1);
     size_t processed = 0;
 
-    for (int i = 0; i < grid_size_x; i++) {
-        for (int j = 0; j < grid_size_y; j++) {
-            for (int k = 0; k < grid_size_z; k++) {
-                Point3DMC grid_point(
-                    min_bounds.x + i * cell_size,
-                    min_bounds.y + j * cell_size,
-                    min_bounds.z + k * cell_size
-                );
-
-                float value = 0.0f;
-                
-                auto nearby_points = spatial_hash.get_nearby_points(grid_point, influence_radius);
+    for_each_field_block(grid_size_x, grid_size_y, first_layer, last_layer, field_layout == FieldLayout::Bricked,
+                         [&](int x0, int x1, int y0, int y1, int z0, int z1) {
+        for (int k = z0; k < z1; k++) {
+            for (int j = y0; j < y1; j++) {
+                for (int i = x0; i < x1; i++) {
+                    field[field_offset(i, j, k)] = field_value_at(spatial_hash, i, j, k);
+                    processed++;
                 
-                for (auto* point : nearby_points) {
-                    float dx = grid_point.x - point->x;
-                    float dy = grid_point.y - point->y;
-                    float dz = grid_point.z - point->z;
-                    float distance_sq = dx * dx + dy * dy + dz * dz;
-                    
-                    if (distance_sq < influence_radius * influence_radius) {
-                        float weight = exp(-distance_sq / (2.0f * cell_size * cell_size));
-                        value += weight;
+                    if (processed % progress_step == 0) {
+                        std::cout << "Scalar field progress: " << (processed * 100) / total_cells << "%" << std::endl;
                     }
                 }
-                
-                scalar_field[i][j][k] = value;
-                processed++;
-                
-                if (processed % progress_step == 0) {
-                    std::cout << "Scalar field progress: " << (processed * 100) / total_cells << "%" << std::endl;
-                }
             }
         }
-    }
+    });
     
     std::cout << "Scalar field calculation complete." << std::endl;
 }
 
-int MarchingCubes::add_or_find_vertex(const Point3DMC& vertex) {
-    auto iterator = vertex_map.find(vertex);
-    if (iterator != vertex_map.end()) {
-        return iterator->second;
+// Diferencia admitida entre el centro de un bloque y la media de sus esquinas, relativa al nivel iso
+constexpr float adaptive_field_tolerance = 0.05f;
+
+// Campo muestreado sobre un octree de bloques de 2^adaptive_depth celdas. Lejos de los puntos el campo
+// vale exactamente 0 y no se evalúa; cerca de ellos un bloque se subdivide salvo que sus esquinas y su
+// centro queden dentro de todos los niveles iso y el centro coincida con la media de las esquinas.
+// Las muestras de los bloques sin subdividir se interpolan de sus esquinas, así que es una aproximación:
+// una depresión del campo dentro de un bloque que no llega a sus esquinas ni a su centro se pierde y la
+// superficie cercana puede cambiar un poco. Con adaptive_depth = 0 el campo se evalúa completo
+void MarchingCubes::calculate_adaptive_field(float* field, const std::vector<float>& iso_levels) {
+    int cells_x = grid_size_x - 1;
+    int cells_y = grid_size_y - 1;
+    int cells_z = grid_size_z - 1;
+    if (cells_x <= 0 || cells_y <= 0 || cells_z <= 0 || adaptive_depth <= 0) {
+        calculate_field_layers(field, 0, grid_size_z);
+        return;
     }
 
-    int index = unique_vertices.size();
-    unique_vertices.push_back(vertex);
-    vertex_normals.push_back(Point3DMC(0, 0, 0));
-    vertex_map[vertex] = index;
+    // Celdas alcanzadas por algún núcleo (las dos celdas vecinas de cada muestra con valor distinto de 0)
+    // y una pirámide con la ocupación de cada bloque del octree
+    struct OccupancyLevel {
+        int size_x, size_y, size_z;
+        std::vector<uint8_t> cells;
+        bool occupied(int x, int y, int z) const {
+            return cells[((size_t)z * size_y + y) * size_x + x] != 0;
+        }
+    };
+    std::vector<OccupancyLevel> occupancy(adaptive_depth + 1);
+    OccupancyLevel& fine = occupancy[0];
+    fine.size_x = cells_x;
+    fine.size_y = cells_y;
+    fine.size_z = cells_z;
+    fine.cells.assign((size_t)cells_x * cells_y * cells_z, 0);
+    for (const auto& point : point_cloud) {
+        int x = std::clamp((int)((point.x - min_bounds.x) / cell_size), 0, cells_x - 1);
+        int y = std::clamp((int)((point.y - min_bounds.y) / cell_size), 0, cells_y - 1);
+        int z = std::clamp((int)((point.z - min_bounds.z) / cell_size), 0, cells_z - 1);
+        fine.cells[((size_t)z * cells_y + y) * cells_x + x] = 1;
+    }
 
-    return index;
-}
+    int reach = (int)std::ceil(influence_radius / cell_size) + 1;
+    const int axis_cells[3] = { cells_x, cells_y, cells_z };
+    const size_t axis_stride[3] = { 1, (size_t)cells_x, (size_t)cells_x * cells_y };
+    for (int axis = 0; axis < 3; axis++) {
+        std::vector<uint8_t> dilated(fine.cells.size(), 0);
+        for (size_t cell = 0; cell < fine.cells.size(); cell++) {
+            if (!fine.cells[cell]) {
+                continue;
+            }
+            int coordinate = (int)((cell / axis_stride[axis]) % axis_cells[axis]);
+            int low = std::max(coordinate - reach, 0);
+            int high = std::min(coordinate + reach, axis_cells[axis] - 1);
+            size_t first = cell - (size_t)(coordinate - low) * axis_stride[axis];
+            for (int c = 0; c <= high - low; c++) {
+                dilated[first + (size_t)c * axis_stride[axis]] = 1;
+            }
+        }
+        fine.cells.swap(dilated);
+    }
+
+    for (int level = 1; level <= adaptive_depth; level++) {
+        const OccupancyLevel& child = occupancy[level - 1];
+        OccupancyLevel& parent = occupancy[level];
+        parent.size_x = (child.size_x + 1) / 2;
+        parent.size_y = (child.size_y + 1) / 2;
+        parent.size_z = (child.size_z + 1) / 2;
+        parent.cells.assign((size_t)parent.size_x * parent.size_y * parent.size_z, 0);
+        for (int z = 0; z < child.size_z; z++) {
+            for (int y = 0; y < child.size_y; y++) {
+                for (int x = 0; x < child.size_x; x++) {
+                    if (child.occupied(x, y, z)) {
+                        parent.cells[((size_t)(z >> 1) * parent.size_y + (y >> 1)) * parent.size_x + (x >> 1)] = 1;
+                    }
+                }
+            }
+        }
+    }
+
+    SpatialHash spatial_hash(influence_radius);
+    for (auto& point : point_cloud) {
+        spatial_hash.insert(&point);
+    }
+
+    // NaN marca las muestras que todavía no se evaluaron ni se interpolaron
+    const float pending = std::numeric_limits<float>::quiet_NaN();
+    for (int z = 0; z < grid_size_z; z++) {
+        for (int y = 0; y < grid_size_y; y++) {
+            for (int x = 0; x < grid_size_x; x++) {
+                field[field_offset(x, y, z)] = pending;
+            }
+        }
+    }
+
+    size_t evaluated = 0;
+    auto sample = [&](int x, int y, int z) {
+        float& value = field[field_offset(x, y, z)];
+        if (std::isnan(value)) {
+            value = field_value_at(spatial_hash, x, y, z);
+            evaluated++;
+        }
+        return value;
+    };
+
+    float max_iso = *std::max_element(iso_levels.begin(), iso_levels.end());
+    struct FieldBlock {
+        int x, y, z, level;
+    };
+    std::vector<FieldBlock> pending_blocks;
+    std::vector<FieldBlock> coarse_blocks;
+    int top_size = 1 << adaptive_depth;
+    for (int z = 0; z < cells_z; z += top_size) {
+        for (int y = 0; y < cells_y; y += top_size) {
+            for (int x = 0; x < cells_x; x += top_size) {
+                pending_blocks.push_back({ x, y, z, adaptive_depth });
+            }
+        }
+    }
+
+    while (!pending_blocks.empty()) {
+        FieldBlock block = pending_blocks.back();
+        pending_blocks.pop_back();
+        if (!occupancy[block.level].occupied(block.x >> block.level, block.y >> block.level, block.z >> block.level)) {
+            continue;
+        }
+
+        int size = 1 << block.level;
+        int x1 = std::min(block.x + size, cells_x);
+        int y1 = std::min(block.y + size, cells_y);
+        int z1 = std::min(block.z + size, cells_z);
+        if (block.level == 0) {
+            for (int corner = 0; corner < 8; corner++) {
+                sample(corner & 1 ? x1 : block.x, corner & 2 ? y1 : block.y, corner & 4 ? z1 : block.z);
+            }
+            continue;
+        }
+
+        bool inside = true;
+        float corner_sum = 0.0f;
+        for (int corner = 0; corner < 8; corner++) {
+            float value = sample(corner & 1 ? x1 : block.x, corner & 2 ? y1 : block.y, corner & 4 ? z1 : block.z);
+            inside = inside && value >= max_iso;
+            corner_sum += value;
+        }
+        float center = sample((block.x + x1) / 2, (block.y + y1) / 2, (block.z + z1) / 2);
+        inside = inside && center >= max_iso;
+
+        if (inside && std::abs(center - corner_sum * 0.125f) <= adaptive_field_tolerance * max_iso) {
+            coarse_blocks.push_back(block);
+            continue;
+        }
 
-void MarchingCubes::calculate_vertex_normals() {
-    for (auto& normal : vertex_normals) {
-        normal = Point3DMC(0, 0, 0);
+        int half = size / 2;
+        for (int child = 0; child < 8; child++) {
+            int cx = block.x + (child & 1 ? half : 0);
+            int cy = block.y + (child & 2 ? half : 0);
+            int cz = block.z + (child & 4 ? half : 0);
+            if (cx < cells_x && cy < cells_y && cz < cells_z) {
+                pending_blocks.push_back({ cx, cy, cz, block.level - 1 });
+            }
+        }
     }
 
-    for (const auto& triangle : triangles) {
-        for (int i = 0; i < 3; i++) {
-            int vertex_idx = triangle.vertexes_index[i];
-            vertex_normals[vertex_idx] = vertex_normals[vertex_idx] + triangle.normalize;
+    // Interior de los bloques gruesos por interpolación trilineal y el resto del espacio vacío en 0
+    for (const auto& block : coarse_blocks) {
+        int size = 1 << block.level;
+        int x1 = std::min(block.x + size, cells_x);
+        int y1 = std::min(block.y + size, cells_y);
+        int z1 = std::min(block.z + size, cells_z);
+        float corner_value[8];
+        for (int corner = 0; corner < 8; corner++) {
+            corner_value[corner] = field[field_offset(corner & 1 ? x1 : block.x, corner & 2 ? y1 : block.y, corner & 4 ? z1 : block.z)];
+        }
+        for (int z = block.z; z <= z1; z++) {
+            float tz = (float)(z - block.z) / (z1 - block.z);
+            for (int y = block.y; y <= y1; y++) {
+                float ty = (float)(y - block.y) / (y1 - block.y);
+                for (int x = block.x; x <= x1; x++) {
+                    float& value = field[field_offset(x, y, z)];
+                    if (!std::isnan(value)) {
+                        continue;
+                    }
+                    float tx = (float)(x - block.x) / (x1 - block.x);
+                    float c00 = corner_value[0] + (corner_value[1] - corner_value[0]) * tx;
+                    float c10 = corner_value[2] + (corner_value[3] - corner_value[2]) * tx;
+                    float c01 = corner_value[4] + (corner_value[5] - corner_value[4]) * tx;
+                    float c11 = corner_value[6] + (corner_value[7] - corner_value[6]) * tx;
+                    float c0 = c00 + (c10 - c00) * ty;
+                    float c1 = c01 + (c11 - c01) * ty;
+                    value = c0 + (c1 - c0) * tz;
+                }
+            }
         }
     }
 
-    for (auto& normal : vertex_normals) {
-        normal = normal.normalize();
+    for (int z = 0; z < grid_size_z; z++) {
+        for (int y = 0; y < grid_size_y; y++) {
+            for (int x = 0; x < grid_size_x; x++) {
+                float& value = field[field_offset(x, y, z)];
+                if (std::isnan(value)) {
+                    value = 0.0f;
+                }
+            }
+        }
     }
+
+    size_t sample_count = (size_t)grid_size_x * grid_size_y * grid_size_z;
+    std::cout << "Adaptive scalar field: " << evaluated << " of " << sample_count << " samples evaluated ("
+              << (evaluated * 100) / sample_count << "%)" << std::endl;
 }
 
-Point3DMC MarchingCubes::vertex_interpolation(const Point3DMC& point_1, const Point3DMC& point_2, float value_1, float value_2, float iso_level) {
+void MarchingCubes::set_cache_directory(const std::string& directory) {
+    cache_directory = directory;
+}
+
+bool MarchingCubes::matches_field_cache(const FieldCacheHeader& header, uint64_t input_hash) const {
+    return std::string(header.magic, 8) == std::string("RC3DFLD\0", 8) &&
+           header.version == field_cache_version &&
+           header.input_hash == input_hash &&
+           header.cell_size == cell_size &&
+           header.influence_radius == influence_radius &&
+           header.kernel_sigma == cell_size &&
+           header.grid_size_x == grid_size_x &&
+           header.grid_size_y == grid_size_y &&
+           header.grid_size_z == grid_size_z &&
+           header.min_bounds[0] == min_bounds.x && header.min_bounds[1] == min_bounds.y && header.min_bounds[2] == min_bounds.z &&
+           header.max_bounds[0] == max_bounds.x && header.max_bounds[1] == max_bounds.y && header.max_bounds[2] == max_bounds.z &&
+           header.field_layout == (uint32_t)field_layout;
+}
+
+bool MarchingCubes::load_field_cache(const std::string& cache_file, uint64_t input_hash) {
+    MappedFile file;
+    if (!file.open_read(cache_file) || file.size() < sizeof(FieldCacheHeader)) {
+        return false;
+    }
+
+    FieldCacheHeader header;
+    std::memcpy(&header, file.data(), sizeof(FieldCacheHeader));
+    size_t field_bytes = field_storage_size() * sizeof(float);
+    if (!matches_field_cache(header, input_hash) || file.size() < header.data_offset + field_bytes) {
+        return false;
+    }
+
+    scalar_field.clear();
+    field_cache_file = std::move(file);
+    field_values = reinterpret_cast<const float*>(field_cache_file.data() + header.data_offset);
+    if (mapped_storage) {
+        field_cache_file.advise(MappedAccess::Sequential);
+    }
+
+    std::cout << "Scalar field loaded from cache: " << cache_file << std::endl;
+    return true;
+}
+
+FieldCacheHeader MarchingCubes::field_cache_header(uint64_t input_hash) const {
+    FieldCacheHeader header = {};
+    std::memcpy(header.magic, "RC3DFLD\0", 8);
+    header.version = field_cache_version;
+    header.data_offset = field_cache_data_offset;
+    header.input_hash = input_hash;
+    header.cell_size = cell_size;
+    header.influence_radius = influence_radius;
+    header.kernel_sigma = cell_size;
+    header.grid_size_x = grid_size_x;
+    header.grid_size_y = grid_size_y;
+    header.grid_size_z = grid_size_z;
+    header.min_bounds[0] = min_bounds.x;
+    header.min_bounds[1] = min_bounds.y;
+    header.min_bounds[2] = min_bounds.z;
+    header.max_bounds[0] = max_bounds.x;
+    header.max_bounds[1] = max_bounds.y;
+    header.max_bounds[2] = max_bounds.z;
+    header.field_layout = (uint32_t)field_layout;
+    return header;
+}
+
+// El campo se calcula directamente dentro del archivo de caché mapeado: no ocupa memoria anónima,
+// el sistema puede devolver al disco las capas ya escritas y no hace falta guardarlo al terminar
+bool MarchingCubes::calculate_mapped_field(const std::string& cache_file, uint64_t input_hash, const std::vector<float>& iso_levels) {
+    MappedFile file;
+    if (!file.open_write(cache_file, field_cache_data_offset + field_storage_size() * sizeof(float))) {
+        std::cerr << "Error mapping field cache for writing: " << cache_file << std::endl;
+        return false;
+    }
+    file.advise(MappedAccess::HugePages);
+    file.advise(MappedAccess::Sequential);
+
+    scalar_field.clear();
+    std::vector<float>().swap(scalar_field);
+    float* field = reinterpret_cast<float*>(file.mutable_data() + field_cache_data_offset);
+    fill_scalar_field(field, iso_levels);
+
+    // La cabecera se escribe al final para que una ejecución interrumpida no deje una caché válida
+    FieldCacheHeader header = field_cache_header(input_hash);
+    std::memcpy(file.mutable_data(), &header, sizeof(header));
+    field_cache_file = std::move(file);
+    field_values = field;
+
+    std::cout << "Scalar field computed in mapped file: " << cache_file << std::endl;
+    return true;
+}
+
+bool MarchingCubes::save_field_cache(const std::string& cache_file, uint64_t input_hash) const {
+    if (!field_values) {
+        return false;
+    }
+
+    std::ofstream file(cache_file, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Error opening cache file for writing: " << cache_file << std::endl;
+        return false;
+    }
+
+    FieldCacheHeader header = field_cache_header(input_hash);
+
+    char padding[field_cache_data_offset] = {};
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(padding, header.data_offset - sizeof(header));
+    file.write(reinterpret_cast<const char*>(field_values),
+               (std::streamsize)(field_storage_size() * sizeof(float)));
+    return file.good();
+}
+
+uint32_t MarchingCubes::add_or_find_vertex(MeshData& mesh, uint64_t key, const Point3DMC& vertex, const Point3DMC& normal) {
+    uint32_t index;
+    if (mesh.arena.lookup.find_or_insert(key, (uint32_t)mesh.arena.positions.size(), index)) {
+        return index;
+    }
+
+    const float position[3] = { vertex.x, vertex.y, vertex.z };
+    const float vertex_normal[3] = { normal.x, normal.y, normal.z };
+    return mesh.arena.add_vertex(position, vertex_normal);
+}
+
+uint64_t MarchingCubes::edge_vertex_key(int x, int y, int z, int edge, float mu) const {
+    // Un vértice sobre una esquina se comparte entre todas las aristas que llegan a ella
+    if (mu == 0.0f || mu == 1.0f) {
+        int corner = edge_index_pairs[edge][mu == 0.0f ? 0 : 1];
+        return (uint64_t)field_index(
+            x + (int)cube_vertex_offset[corner].x,
+            y + (int)cube_vertex_offset[corner].y,
+            z + (int)cube_vertex_offset[corner].z
+        ) * 4 + 3;
+    }
+
+    const int* offset = edge_grid_offset[edge];
+    return (uint64_t)field_index(x + offset[0], y + offset[1], z + offset[2]) * 4 + offset[3];
+}
+
+float MarchingCubes::interpolation_factor(float value_1, float value_2, float iso_level) const {
     if (std::abs(iso_level - value_1) < 1e-6f) {
-        return point_1;
+        return 0.0f;
     }
     if (std::abs(iso_level - value_2) < 1e-6f) {
-        return point_2;
+        return 1.0f;
     }
     if (std::abs(value_1 - value_2) < 1e-6f) {
-        return point_1;
+        return 0.0f;
     }
+    return (iso_level - value_1) / (value_2 - value_1);
+}
 
-    float mu = (iso_level - value_1) / (value_2 - value_1);
+Point3DMC MarchingCubes::vertex_interpolation(const Point3DMC& point_1, const Point3DMC& point_2, float value_1, float value_2, float iso_level) {
+    float mu = interpolation_factor(value_1, value_2, iso_level);
+    if (mu == 0.0f) {
+        return point_1;
+    }
+    if (mu == 1.0f) {
+        return point_2;
+    }
     return point_1 + (point_2 - point_1) * mu;
 }
 
@@ -478,162 +959,1839 @@ Point3DMC MarchingCubes::get_grid_point(int x, int y, int z) {
 
 float MarchingCubes::get_scalar_value(int x, int y, int z) {
     if (x >= 0 && x < grid_size_x && y >= 0 && y < grid_size_y && z >= 0 && z < grid_size_z) {
-        return scalar_field[x][y][z];
+        return field_values[field_offset(x, y, z)];
     }
     return 0.0f;
 }
 
-void MarchingCubes::process_cube(int x, int y, int z, float iso_level) {
-    Point3DMC vertex_list[12];
-    GridCell cell;
-
-    for (int i = 0; i < 8; i++) {
-        int xi = x + (int)cube_vertex_offset[i].x;
-        int yi = y + (int)cube_vertex_offset[i].y;
-        int zi = z + (int)cube_vertex_offset[i].z;
-
-        cell.point[i] = get_grid_point(xi, yi, zi);
-        cell.value[i] = get_scalar_value(xi, yi, zi);
-    }
+Point3DMC MarchingCubes::get_gradient(int x, int y, int z) {
+    float scale = 1.0f / (2.0f * cell_size);
+    return Point3DMC(
+        (get_scalar_value(x + 1, y, z) - get_scalar_value(x - 1, y, z)) * scale,
+        (get_scalar_value(x, y + 1, z) - get_scalar_value(x, y - 1, z)) * scale,
+        (get_scalar_value(x, y, z + 1) - get_scalar_value(x, y, z - 1)) * scale
+    );
+}
 
-    int cube_index = 0;
-    for (int i = 0; i < 8; i++) {
-        if (cell.value[i] < iso_level) {
-            cube_index |= (1 << i);
-        }
-    }
+void MarchingCubes::set_normal_mode(NormalMode mode) {
+    normal_mode = mode;
+}
 
-    int edges = edge_table[cube_index];
-    if (edges == 0) {
-        return;
-    }
+// El radio de corte del núcleo gaussiano en múltiplos de sigma (= cell_size)
+void MarchingCubes::set_kernel_radius_factor(float factor) {
+    influence_radius = cell_size * factor;
+}
 
-    for (int i = 0; i < 12; i++) {
-        if (edges & (1 << i)) {
-            int v1 = edge_index_pairs[i][0];
-            int v2 = edge_index_pairs[i][1];
-            vertex_list[i] = vertex_interpolation(
-                cell.point[v1], cell.point[v2],
-                cell.value[v1], cell.value[v2],
-                iso_level
-            );
-        }
-    }
+void MarchingCubes::set_meshing_mode(MeshingMode mode) {
+    meshing_mode = mode;
+}
 
-    for (int i = 0; tri_table[cube_index][i] != -1; i += 3) {
-        Triangle triangle;
+void MarchingCubes::set_field_layout(FieldLayout layout) {
+    field_layout = layout;
+}
 
-        Point3DMC v0 = vertex_list[tri_table[cube_index][i]];
-        Point3DMC v1 = vertex_list[tri_table[cube_index][i + 1]];
-        Point3DMC v2 = vertex_list[tri_table[cube_index][i + 2]];
+// El campo calculado se escribe directamente en su archivo de caché mapeado
+void MarchingCubes::set_mapped_storage(bool enabled) {
+    mapped_storage = enabled;
+}
 
-        triangle.vertexes_index[0] = add_or_find_vertex(v0);
-        triangle.vertexes_index[1] = add_or_find_vertex(v1);
-        triangle.vertexes_index[2] = add_or_find_vertex(v2);
+// Un .rmesh por nivel iso donde se escribe cada malla terminada; después la malla ya no queda en memoria
+void MarchingCubes::set_mapped_output(const std::vector<std::string>& mesh_files) {
+    mapped_mesh_files = mesh_files;
+}
 
-        Point3DMC vec1 = v1 - v0;
-        Point3DMC vec2 = v2 - v0;
+// Distancia media a los planos tangentes, en celdas, que se admite al fusionar ocho hojas del octree
+void MarchingCubes::set_adaptive_tolerance(float tolerance) {
+    adaptive_tolerance = tolerance;
+}
 
-        triangle.normalize = Point3DMC(
-            vec1.y * vec2.z - vec1.z * vec2.y,
-            vec1.z * vec2.x - vec1.x * vec2.z,
-            vec1.x * vec2.y - vec1.y * vec2.x
-        );
+// Niveles del octree: los bloques y las celdas fusionadas llegan a 2^depth celdas por lado
+void MarchingCubes::set_adaptive_depth(int depth) {
+    adaptive_depth = std::max(depth, 0);
+}
 
-        triangle.normalize = triangle.normalize.normalize();
-        triangles.push_back(triangle);
+template <FieldLayout layout, bool interior>
+float MarchingCubes::field_sample(int x, int y, int z) const {
+    if (!interior && (x < 0 || x >= grid_size_x || y < 0 || y >= grid_size_y || z < 0 || z >= grid_size_z)) {
+        return 0.0f;
     }
+    return field_values[field_offset_as<layout>(x, y, z)];
 }
 
-void MarchingCubes::generate_mesh(float iso_level) {
-    clear_mesh();
+// Núcleo de Marching Cubes especializado en compilación. En las celdas interiores todas las lecturas
+// (esquinas y, con normales del gradiente, sus vecinas) caen dentro de la malla y no se controlan bordes
+template <NormalMode normals, FieldLayout layout, bool interior>
+void MarchingCubes::process_cube_kernel(int x, int y, int z) {
+    float value[8];
+    for (int i = 0; i < 8; i++) {
+        value[i] = field_sample<layout, interior>(x + cube_corner[i][0], y + cube_corner[i][1], z + cube_corner[i][2]);
+    }
 
-    int total_voxels = (grid_size_x - 1) * (grid_size_y - 1) * (grid_size_z - 1);
-    int processed_voxels = 0;
-    int last_progress = 0;
+    Point3DMC gradients[8];
+    bool gradients_ready = false;
+    float scale = 1.0f / (2.0f * cell_size);
 
-    for (int z = 0; z < grid_size_z - 1; z++) {
-        int layer_progress = (z * 100) / (grid_size_z - 1);
-        if (layer_progress != last_progress) {
-            std::cout << "Progress: " << layer_progress << "%" << std::endl;
-            last_progress = layer_progress;
+    for (auto& mesh : meshes) {
+        float iso_level = mesh.iso_level;
+        int cube_index = 0;
+        for (int i = 0; i < 8; i++) {
+            cube_index |= (value[i] < iso_level) << i;
         }
-        for (int y = 0; y < grid_size_y - 1; y++) {
-            for (int x = 0; x < grid_size_x - 1; x++) {
-                process_cube(x, y, z, iso_level);
-                processed_voxels++;
-            }
+
+        const CubeCase& cube_case = cube_cases[cube_index];
+        if (cube_case.triangle_count == 0) {
+            continue;
         }
-    }
 
-    calculate_vertex_normals();
-    std::cout << "Mesh generation complete."<< std::endl;
-    print_mesh_stats();
-}
+        if (normals == NormalMode::Gradient && !gradients_ready) {
+            for (int i = 0; i < 8; i++) {
+                int xi = x + cube_corner[i][0], yi = y + cube_corner[i][1], zi = z + cube_corner[i][2];
+                gradients[i] = Point3DMC(
+                    (field_sample<layout, interior>(xi + 1, yi, zi) - field_sample<layout, interior>(xi - 1, yi, zi)) * scale,
+                    (field_sample<layout, interior>(xi, yi + 1, zi) - field_sample<layout, interior>(xi, yi - 1, zi)) * scale,
+                    (field_sample<layout, interior>(xi, yi, zi + 1) - field_sample<layout, interior>(xi, yi, zi - 1)) * scale
+                );
+            }
+            gradients_ready = true;
+        }
 
-void MarchingCubes::process_point_cloud(const std::string& file_cloud, float cell_size) {
-    if (!load_points_cloud(file_cloud)) {
-        return;
-    }
+        Point3DMC vertex_list[12];
+        Point3DMC normal_list[12];
+        uint64_t key_list[12];
+        for (int e = 0; e < cube_case.edge_count; e++) {
+            int edge = cube_case.edges[e];
+            int v1 = edge_index_pairs[edge][0];
+            int v2 = edge_index_pairs[edge][1];
+            float mu = interpolation_factor(value[v1], value[v2], iso_level);
+            Point3DMC point_1 = get_grid_point(x + cube_corner[v1][0], y + cube_corner[v1][1], z + cube_corner[v1][2]);
+            Point3DMC point_2 = get_grid_point(x + cube_corner[v2][0], y + cube_corner[v2][1], z + cube_corner[v2][2]);
+            vertex_list[edge] = mu == 0.0f ? point_1 : (mu == 1.0f ? point_2 : point_1 + (point_2 - point_1) * mu);
+            key_list[edge] = edge_vertex_key(x, y, z, edge, mu);
 
-    initialize_grid();
-    calculate_scalar_field();
-    generate_mesh();
-}
+            if (normals == NormalMode::Gradient) {
+                // El campo crece hacia el interior, la normal apunta en contra del gradiente
+                Point3DMC gradient = gradients[v1] + (gradients[v2] - gradients[v1]) * mu;
+                normal_list[edge] = (gradient * -1.0f).normalize();
+            }
+        }
 
-void MarchingCubes::clear_mesh() {
-    triangles.clear();
-    unique_vertices.clear();
-    vertex_normals.clear();
-    vertex_map.clear();
+        for (int t = 0; t < cube_case.triangle_count * 3; t += 3) {
+            uint32_t triangle[3];
+            for (int j = 0; j < 3; j++) {
+                int edge = cube_case.triangles[t + j];
+                triangle[j] = add_or_find_vertex(mesh, key_list[edge], vertex_list[edge], normal_list[edge]);
+            }
+            mesh.arena.add_triangle(triangle[0], triangle[1], triangle[2]);
+        }
+    }
 }
 
-const std::vector<Triangle>& MarchingCubes::get_triangles() const {
-    return triangles;
-}
+// Las celdas de la fila que tocan el borde usan el núcleo con controles; el tramo interior, el que no los tiene
+template <NormalMode normals, FieldLayout layout>
+void MarchingCubes::march_row_kernel(int x_begin, int x_end, int y, int z) {
+    // Con normales del gradiente se lee además una muestra más allá de cada esquina
+    const int reach = normals == NormalMode::Gradient ? 1 : 0;
+    int inner_begin = x_end;
+    int inner_end = x_end;
+    if (y >= reach && y + 1 + reach < grid_size_y && z >= reach && z + 1 + reach < grid_size_z) {
+        inner_begin = std::min(std::max(x_begin, reach), x_end);
+        inner_end = std::max(std::min(x_end, grid_size_x - 1 - reach), inner_begin);
+    }
 
-const std::vector<Point3DMC>& MarchingCubes::get_unique_vertices() const {
-    return unique_vertices;
+    int x = x_begin;
+    for (; x < inner_begin; x++) {
+        process_cube_kernel<normals, layout, false>(x, y, z);
+    }
+    for (; x < inner_end; x++) {
+        process_cube_kernel<normals, layout, true>(x, y, z);
+    }
+    for (; x < x_end; x++) {
+        process_cube_kernel<normals, layout, false>(x, y, z);
+    }
 }
 
-const std::vector<Point3DMC>& MarchingCubes::get_vertex_normals() const {
-    return vertex_normals;
+void MarchingCubes::march_row(int x_begin, int x_end, int y, int z) {
+    if (normal_mode == NormalMode::Gradient) {
+        if (field_layout == FieldLayout::Bricked) {
+            march_row_kernel<NormalMode::Gradient, FieldLayout::Bricked>(x_begin, x_end, y, z);
+        } else {
+            march_row_kernel<NormalMode::Gradient, FieldLayout::Linear>(x_begin, x_end, y, z);
+        }
+    } else {
+        if (field_layout == FieldLayout::Bricked) {
+            march_row_kernel<NormalMode::Face, FieldLayout::Bricked>(x_begin, x_end, y, z);
+        } else {
+            march_row_kernel<NormalMode::Face, FieldLayout::Linear>(x_begin, x_end, y, z);
+        }
+    }
 }
 
-void MarchingCubes::print_mesh_stats() const {
-    std::cout << "Mesh Statistics:" << std::endl;
-    std::cout << "Triangles: " << triangles.size() << std::endl;
-    std::cout << "Unique Vertices: " << unique_vertices.size() << std::endl;
-    std::cout << "Vertex Normals: " << vertex_normals.size() << std::endl;
+void MarchingCubes::process_cube(int x, int y, int z) {
+    march_row(x, x + 1, y, z);
 }
 
-void MarchingCubes::export_file_obj(const std::string& fileobj) {
-    std::ofstream file(fileobj);
-    if (!file.is_open()) {
-        std::cerr << "Error opening file for writing: " << fileobj << std::endl;
-        return;
+// Vértice de una celda activa: promedio de los cruces en las aristas (Surface Nets)
+// o mínimo de la QEF de los planos tangentes en los cruces (Dual Contouring)
+bool MarchingCubes::dual_cell_vertex(int x, int y, int z, float iso_level, float position[3], float normal[3]) {
+    float values[8];
+    int inside = 0;
+    for (int i = 0; i < 8; i++) {
+        values[i] = get_scalar_value(x + (int)cube_vertex_offset[i].x, y + (int)cube_vertex_offset[i].y, z + (int)cube_vertex_offset[i].z);
+        if (values[i] < iso_level) {
+            inside |= 1 << i;
+        }
+    }
+    if (inside == 0 || inside == 255) {
+        return false;
     }
 
-    for (const auto& vertex : unique_vertices) {
-        file << "v " << vertex.x << " " << vertex.y << " " << vertex.z << "\n";
+    bool use_gradients = meshing_mode == MeshingMode::DualContouring || normal_mode == NormalMode::Gradient;
+    Point3DMC gradients[8];
+    if (use_gradients) {
+        for (int i = 0; i < 8; i++) {
+            gradients[i] = get_gradient(x + (int)cube_vertex_offset[i].x, y + (int)cube_vertex_offset[i].y, z + (int)cube_vertex_offset[i].z);
+        }
     }
 
-    for (const auto& normal : vertex_normals) {
-        file << "vn " << normal.x << " " << normal.y << " " << normal.z << "\n";
+    Point3DMC mass_point;
+    int crossings = 0;
+    Eigen::Matrix3d ata = Eigen::Matrix3d::Zero();
+    Eigen::Vector3d atb = Eigen::Vector3d::Zero();
+    Point3DMC crossing_points[12];
+    Point3DMC crossing_normals[12];
+
+    for (int i = 0; i < 12; i++) {
+        int v1 = edge_index_pairs[i][0];
+        int v2 = edge_index_pairs[i][1];
+        if (((inside >> v1) & 1) == ((inside >> v2) & 1)) {
+            continue;
+        }
+        float mu = interpolation_factor(values[v1], values[v2], iso_level);
+        Point3DMC point = cube_vertex_offset[v1] + (cube_vertex_offset[v2] - cube_vertex_offset[v1]) * mu;
+        mass_point = mass_point + point;
+        crossing_points[crossings] = point;
+        if (use_gradients) {
+            crossing_normals[crossings] = (gradients[v1] + (gradients[v2] - gradients[v1]) * mu).normalize();
+        }
+        crossings++;
     }
+    mass_point = mass_point * (1.0f / crossings);
 
-    for (const auto& triangle : triangles) {
-        file << "f";
-        for (int i = 0; i < 3; i++) {
-            int index = triangle.vertexes_index[i] + 1;
-            file << " " << index << "//" << index;
-            if (i < 2) {
-                file << " ";
-            }
+    Point3DMC local = mass_point;
+    if (meshing_mode == MeshingMode::DualContouring) {
+        for (int i = 0; i < crossings; i++) {
+            Eigen::Vector3d n(crossing_normals[i].x, crossing_normals[i].y, crossing_normals[i].z);
+            Eigen::Vector3d offset(crossing_points[i].x - mass_point.x, crossing_points[i].y - mass_point.y, crossing_points[i].z - mass_point.z);
+            ata += n * n.transpose();
+            atb += n * n.dot(offset);
+        }
+
+        // Pseudo-inversa truncada alrededor del centro de masa para que las celdas planas no se disparen
+        Eigen::JacobiSVD<Eigen::Matrix3d> svd(ata, Eigen::ComputeFullU | Eigen::ComputeFullV);
+        svd.setThreshold(0.1);
+        Eigen::Vector3d solution = svd.solve(atb);
+        if (solution.allFinite()) {
+            local = Point3DMC(
+                std::min(std::max(mass_point.x + (float)solution.x(), 0.0f), 1.0f),
+                std::min(std::max(mass_point.y + (float)solution.y(), 0.0f), 1.0f),
+                std::min(std::max(mass_point.z + (float)solution.z(), 0.0f), 1.0f)
+            );
         }
-        file << "\n";
     }
 
-    file.close();
-    std::cout << "Mesh exported to " << fileobj << std::endl;
-}
\ No newline at end of file
+    position[0] = min_bounds.x + (x + local.x) * cell_size;
+    position[1] = min_bounds.y + (y + local.y) * cell_size;
+    position[2] = min_bounds.z + (z + local.z) * cell_size;
+
+    normal[0] = normal[1] = normal[2] = 0.0f;
+    if (normal_mode == NormalMode::Gradient) {
+        // Interpolación trilineal del gradiente de las esquinas, en contra del gradiente como en process_cube
+        Point3DMC gradient;
+        for (int i = 0; i < 8; i++) {
+            float weight = (cube_vertex_offset[i].x > 0 ? local.x : 1.0f - local.x) *
+                           (cube_vertex_offset[i].y > 0 ? local.y : 1.0f - local.y) *
+                           (cube_vertex_offset[i].z > 0 ? local.z : 1.0f - local.z);
+            gradient = gradient + gradients[i] * weight;
+        }
+        Point3DMC result = (gradient * -1.0f).normalize();
+        normal[0] = result.x;
+        normal[1] = result.y;
+        normal[2] = result.z;
+    }
+    return true;
+}
+
+void MarchingCubes::generate_dual_mesh(MeshData& mesh) {
+    int cells_x = grid_size_x - 1;
+    int cells_y = grid_size_y - 1;
+    int cells_z = grid_size_z - 1;
+    if (cells_x <= 0 || cells_y <= 0 || cells_z <= 0) {
+        return;
+    }
+
+    float iso_level = mesh.iso_level;
+    auto cell_index = [&](int x, int y, int z) {
+        return ((size_t)z * cells_y + y) * cells_x + x;
+    };
+    std::vector<uint32_t> cell_vertex((size_t)cells_x * cells_y * cells_z, UINT32_MAX);
+
+    // Las capas Z se reparten en bloques independientes; el resultado no depende de la cantidad de hilos
+    size_t slab_count = std::min<size_t>((size_t)cells_z, 64);
+    auto slab_begin = [&](size_t slab) { return (int)(slab * cells_z / slab_count); };
+    std::vector<MeshBuffers> slab_vertices(slab_count);
+
+    parallel_for(0, slab_count, [&](size_t begin, size_t end, size_t) {
+        for (size_t slab = begin; slab < end; slab++) {
+            MeshBuffers& local = slab_vertices[slab];
+            for (int z = slab_begin(slab); z < slab_begin(slab + 1); z++) {
+                for (int y = 0; y < cells_y; y++) {
+                    for (int x = 0; x < cells_x; x++) {
+                        float position[3], normal[3];
+                        if (dual_cell_vertex(x, y, z, iso_level, position, normal)) {
+                            cell_vertex[cell_index(x, y, z)] = local.add_vertex(position[0], position[1], position[2], normal[0], normal[1], normal[2]);
+                        }
+                    }
+                }
+            }
+        }
+    }, 1);
+
+    std::vector<uint32_t> slab_first(slab_count + 1, 0);
+    for (size_t slab = 0; slab < slab_count; slab++) {
+        slab_first[slab + 1] = slab_first[slab] + (uint32_t)slab_vertices[slab].vertex_count();
+    }
+
+    MeshBuffers& buffers = mesh.buffers;
+    buffers.positions.resize((size_t)slab_first[slab_count] * 3);
+    buffers.normals.resize((size_t)slab_first[slab_count] * 3);
+
+    parallel_for(0, slab_count, [&](size_t begin, size_t end, size_t) {
+        for (size_t slab = begin; slab < end; slab++) {
+            const MeshBuffers& local = slab_vertices[slab];
+            std::copy(local.positions.begin(), local.positions.end(), buffers.positions.begin() + (size_t)slab_first[slab] * 3);
+            std::copy(local.normals.begin(), local.normals.end(), buffers.normals.begin() + (size_t)slab_first[slab] * 3);
+            for (int z = slab_begin(slab); z < slab_begin(slab + 1); z++) {
+                for (size_t i = cell_index(0, 0, z); i < cell_index(0, 0, z + 1); i++) {
+                    if (cell_vertex[i] != UINT32_MAX) {
+                        cell_vertex[i] += slab_first[slab];
+                    }
+                }
+            }
+        }
+    }, 1);
+
+    contour_dual_edges(mesh, cell_vertex);
+}
+
+// Cada arista de la malla con cambio de signo une los vértices de las cuatro celdas que la rodean.
+// Si varias de esas celdas pertenecen a la misma hoja del octree el cuadrilátero se reduce a un triángulo
+void MarchingCubes::contour_dual_edges(MeshData& mesh, const std::vector<uint32_t>& cell_vertex) {
+    int cells_x = grid_size_x - 1;
+    int cells_y = grid_size_y - 1;
+    int cells_z = grid_size_z - 1;
+    float iso_level = mesh.iso_level;
+    MeshBuffers& buffers = mesh.buffers;
+    auto cell_index = [&](int x, int y, int z) {
+        return ((size_t)z * cells_y + y) * cells_x + x;
+    };
+
+    size_t slab_count = std::min<size_t>((size_t)cells_z, 64);
+    auto slab_begin = [&](size_t slab) { return (int)(slab * cells_z / slab_count); };
+    std::vector<std::vector<uint32_t>> slab_indices(slab_count);
+
+    parallel_for(0, slab_count, [&](size_t begin, size_t end, size_t) {
+        for (size_t slab = begin; slab < end; slab++) {
+            std::vector<uint32_t>& indices = slab_indices[slab];
+            for (int z = slab_begin(slab); z < slab_begin(slab + 1); z++) {
+                for (int y = 0; y < cells_y; y++) {
+                    for (int x = 0; x < cells_x; x++) {
+                        bool outside = get_scalar_value(x, y, z) < iso_level;
+                        for (int axis = 0; axis < 3; axis++) {
+                            int nx = x + (axis == 0), ny = y + (axis == 1), nz = z + (axis == 2);
+                            if ((get_scalar_value(nx, ny, nz) < iso_level) == outside) {
+                                continue;
+                            }
+
+                            // Celdas alrededor de la arista en sentido antihorario visto desde el eje positivo
+                            int cells[4][3];
+                            if (axis == 0) {
+                                int around[4][3] = { { x, y - 1, z - 1 }, { x, y, z - 1 }, { x, y, z }, { x, y - 1, z } };
+                                std::memcpy(cells, around, sizeof(cells));
+                            } else if (axis == 1) {
+                                int around[4][3] = { { x - 1, y, z - 1 }, { x - 1, y, z }, { x, y, z }, { x, y, z - 1 } };
+                                std::memcpy(cells, around, sizeof(cells));
+                            } else {
+                                int around[4][3] = { { x - 1, y - 1, z }, { x, y - 1, z }, { x, y, z }, { x - 1, y, z } };
+                                std::memcpy(cells, around, sizeof(cells));
+                            }
+
+                            uint32_t quad[4];
+                            bool complete = true;
+                            for (int c = 0; c < 4 && complete; c++) {
+                                if (cells[c][0] < 0 || cells[c][1] < 0 || cells[c][2] < 0) {
+                                    complete = false;
+                                    break;
+                                }
+                                quad[c] = cell_vertex[cell_index(cells[c][0], cells[c][1], cells[c][2])];
+                                complete = quad[c] != UINT32_MAX;
+                            }
+                            if (!complete) {
+                                continue;
+                            }
+
+                            // La normal del quad debe apuntar hacia el lado exterior (valor menor)
+                            if (outside) {
+                                std::swap(quad[1], quad[3]);
+                            }
+
+                            uint32_t polygon[4];
+                            int corners = 0;
+                            for (int c = 0; c < 4; c++) {
+                                if (corners == 0 || polygon[corners - 1] != quad[c]) {
+                                    polygon[corners++] = quad[c];
+                                }
+                            }
+                            if (corners > 1 && polygon[corners - 1] == polygon[0]) {
+                                corners--;
+                            }
+                            if (corners < 3) {
+                                continue;
+                            }
+                            if (corners == 3) {
+                                indices.insert(indices.end(), { polygon[0], polygon[1], polygon[2] });
+                                continue;
+                            }
+
+                            // Se corta por la diagonal más corta para evitar triángulos alargados
+                            auto distance2 = [&](uint32_t a, uint32_t b) {
+                                float d = 0.0f;
+                                for (int k = 0; k < 3; k++) {
+                                    float delta = buffers.positions[a * 3 + k] - buffers.positions[b * 3 + k];
+                                    d += delta * delta;
+                                }
+                                return d;
+                            };
+                            if (distance2(polygon[0], polygon[2]) <= distance2(polygon[1], polygon[3])) {
+                                indices.insert(indices.end(), { polygon[0], polygon[1], polygon[2], polygon[0], polygon[2], polygon[3] });
+                            } else {
+                                indices.insert(indices.end(), { polygon[0], polygon[1], polygon[3], polygon[1], polygon[2], polygon[3] });
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }, 1);
+
+    size_t index_count = 0;
+    for (const auto& indices : slab_indices) {
+        index_count += indices.size();
+    }
+    buffers.indices.reserve(index_count);
+    for (const auto& indices : slab_indices) {
+        buffers.indices.insert(buffers.indices.end(), indices.begin(), indices.end());
+    }
+}
+
+// Error cuadrático de los planos tangentes (n · p = d) acumulado en coordenadas de la malla
+struct QuadricError {
+    double ata[6] = { 0, 0, 0, 0, 0, 0 };
+    double atb[3] = { 0, 0, 0 };
+    double btb = 0.0;
+    double mass[3] = { 0, 0, 0 };
+    double normal[3] = { 0, 0, 0 };
+    int count = 0;
+
+    void add_plane(const double point[3], const double n[3]) {
+        double d = n[0] * point[0] + n[1] * point[1] + n[2] * point[2];
+        ata[0] += n[0] * n[0]; ata[1] += n[0] * n[1]; ata[2] += n[0] * n[2];
+        ata[3] += n[1] * n[1]; ata[4] += n[1] * n[2]; ata[5] += n[2] * n[2];
+        for (int k = 0; k < 3; k++) {
+            atb[k] += n[k] * d;
+            mass[k] += point[k];
+            normal[k] += n[k];
+        }
+        btb += d * d;
+        count++;
+    }
+
+    void add(const QuadricError& other) {
+        for (int k = 0; k < 6; k++) ata[k] += other.ata[k];
+        for (int k = 0; k < 3; k++) {
+            atb[k] += other.atb[k];
+            mass[k] += other.mass[k];
+            normal[k] += other.normal[k];
+        }
+        btb += other.btb;
+        count += other.count;
+    }
+
+    // Mínimo dentro de la caja [box_min, box_min + box_size]; devuelve la suma de distancias al cuadrado
+    double solve(const double box_min[3], double box_size, double result[3]) const {
+        Eigen::Matrix3d a;
+        a << ata[0], ata[1], ata[2],
+             ata[1], ata[3], ata[4],
+             ata[2], ata[4], ata[5];
+        Eigen::Vector3d center(mass[0] / count, mass[1] / count, mass[2] / count);
+        Eigen::Vector3d b(atb[0], atb[1], atb[2]);
+
+        Eigen::JacobiSVD<Eigen::Matrix3d> svd(a, Eigen::ComputeFullU | Eigen::ComputeFullV);
+        svd.setThreshold(0.1);
+        Eigen::Vector3d solution = svd.solve(b - a * center);
+        Eigen::Vector3d x = solution.allFinite() ? Eigen::Vector3d(center + solution) : center;
+        for (int k = 0; k < 3; k++) {
+            result[k] = std::min(std::max(x[k], box_min[k]), box_min[k] + box_size);
+            x[k] = result[k];
+        }
+        return std::max(0.0, x.dot(a * x) - 2.0 * x.dot(b) + btb);
+    }
+};
+
+struct AdaptiveNode {
+    int x, y, z;
+    bool leaf;
+    QuadricError qef;
+    double position[3];
+};
+
+// La superficie dentro de un cubo es un solo disco si las esquinas interiores y las exteriores
+// forman cada una un grupo conexo por las aristas del cubo
+static bool single_sheet(int config) {
+    if (config == 0 || config == 255) {
+        return true;
+    }
+    for (int side = 0; side < 2; side++) {
+        int members = side ? config : (~config & 255);
+        int first = 0;
+        while (!((members >> first) & 1)) {
+            first++;
+        }
+        int reached = 1 << first;
+        bool grew = true;
+        while (grew) {
+            grew = false;
+            for (int e = 0; e < 12; e++) {
+                int a = edge_index_pairs[e][0], b = edge_index_pairs[e][1];
+                if (((members >> a) & 1) && ((members >> b) & 1) && (((reached >> a) & 1) != ((reached >> b) & 1))) {
+                    reached |= (1 << a) | (1 << b);
+                    grew = true;
+                }
+            }
+        }
+        if (reached != members) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Prueba de Gerstner-Pajarola sobre las 27 muestras de los ocho hijos: la fusión no cambia la topología
+// si cada punto medio de arista, de cara y el centro coinciden con alguna esquina del padre
+static bool collapse_preserves_topology(const bool outside[3][3][3]) {
+    for (int cz = 0; cz < 2; cz++) {
+        for (int cy = 0; cy < 2; cy++) {
+            for (int cx = 0; cx < 2; cx++) {
+                int config = 0;
+                for (int i = 0; i < 8; i++) {
+                    if (outside[cz + (int)cube_vertex_offset[i].z][cy + (int)cube_vertex_offset[i].y][cx + (int)cube_vertex_offset[i].x]) {
+                        config |= 1 << i;
+                    }
+                }
+                if (!single_sheet(config)) {
+                    return false;
+                }
+            }
+        }
+    }
+
+    int parent = 0;
+    for (int i = 0; i < 8; i++) {
+        if (outside[2 * (int)cube_vertex_offset[i].z][2 * (int)cube_vertex_offset[i].y][2 * (int)cube_vertex_offset[i].x]) {
+            parent |= 1 << i;
+        }
+    }
+    if (!single_sheet(parent)) {
+        return false;
+    }
+
+    // Cada muestra intermedia debe coincidir con alguna esquina del padre en la arista, cara o cubo que la contiene
+    for (int z = 0; z < 3; z++) {
+        for (int y = 0; y < 3; y++) {
+            for (int x = 0; x < 3; x++) {
+                if (x != 1 && y != 1 && z != 1) {
+                    continue;
+                }
+                bool matches = false;
+                for (int cz = (z == 1 ? 0 : z); cz <= (z == 1 ? 2 : z) && !matches; cz += 2) {
+                    for (int cy = (y == 1 ? 0 : y); cy <= (y == 1 ? 2 : y) && !matches; cy += 2) {
+                        for (int cx = (x == 1 ? 0 : x); cx <= (x == 1 ? 2 : x) && !matches; cx += 2) {
+                            matches = outside[cz][cy][cx] == outside[z][y][x];
+                        }
+                    }
+                }
+                if (!matches) {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+// Octree de Dual Contouring: las celdas activas del campo son las hojas iniciales y cada grupo de ocho
+// se fusiona mientras el error de sus planos sea bajo y la topología se conserve. Las caras salen de las
+// aristas finas con cambio de signo, así que entre niveles distintos no quedan grietas.
+void MarchingCubes::generate_adaptive_mesh(MeshData& mesh) {
+    int cells_x = grid_size_x - 1;
+    int cells_y = grid_size_y - 1;
+    int cells_z = grid_size_z - 1;
+    if (cells_x <= 0 || cells_y <= 0 || cells_z <= 0) {
+        return;
+    }
+
+    float iso_level = mesh.iso_level;
+    auto outside_at = [&](int x, int y, int z) {
+        return get_scalar_value(x, y, z) < iso_level;
+    };
+
+    size_t slab_count = std::min<size_t>((size_t)cells_z, 64);
+    auto slab_begin = [&](size_t slab) { return (int)(slab * cells_z / slab_count); };
+    std::vector<std::vector<AdaptiveNode>> slab_nodes(slab_count);
+
+    parallel_for(0, slab_count, [&](size_t begin, size_t end, size_t) {
+        for (size_t slab = begin; slab < end; slab++) {
+            for (int z = slab_begin(slab); z < slab_begin(slab + 1); z++) {
+                for (int y = 0; y < cells_y; y++) {
+                    for (int x = 0; x < cells_x; x++) {
+                        float values[8];
+                        int config = 0;
+                        for (int i = 0; i < 8; i++) {
+                            values[i] = get_scalar_value(x + (int)cube_vertex_offset[i].x, y + (int)cube_vertex_offset[i].y, z + (int)cube_vertex_offset[i].z);
+                            if (values[i] < iso_level) {
+                                config |= 1 << i;
+                            }
+                        }
+                        if (config == 0 || config == 255) {
+                            continue;
+                        }
+
+                        AdaptiveNode node = {};
+                        node.x = x;
+                        node.y = y;
+                        node.z = z;
+                        node.leaf = true;
+                        Point3DMC gradients[8];
+                        for (int i = 0; i < 8; i++) {
+                            gradients[i] = get_gradient(x + (int)cube_vertex_offset[i].x, y + (int)cube_vertex_offset[i].y, z + (int)cube_vertex_offset[i].z);
+                        }
+                        for (int e = 0; e < 12; e++) {
+                            int v1 = edge_index_pairs[e][0];
+                            int v2 = edge_index_pairs[e][1];
+                            if (((config >> v1) & 1) == ((config >> v2) & 1)) {
+                                continue;
+                            }
+                            float mu = interpolation_factor(values[v1], values[v2], iso_level);
+                            Point3DMC point = cube_vertex_offset[v1] + (cube_vertex_offset[v2] - cube_vertex_offset[v1]) * mu;
+                            Point3DMC n = (gradients[v1] + (gradients[v2] - gradients[v1]) * mu).normalize();
+                            double p[3] = { x + (double)point.x, y + (double)point.y, z + (double)point.z };
+                            double nd[3] = { n.x, n.y, n.z };
+                            node.qef.add_plane(p, nd);
+                        }
+
+                        double box_min[3] = { (double)x, (double)y, (double)z };
+                        node.qef.solve(box_min, 1.0, node.position);
+                        slab_nodes[slab].push_back(node);
+                    }
+                }
+            }
+        }
+    }, 1);
+
+    std::vector<AdaptiveNode> nodes;
+    for (auto& local : slab_nodes) {
+        nodes.insert(nodes.end(), local.begin(), local.end());
+        std::vector<AdaptiveNode>().swap(local);
+    }
+    size_t fine_count = nodes.size();
+
+    struct AdaptiveLeaf {
+        int level;
+        AdaptiveNode node;
+    };
+    std::vector<AdaptiveLeaf> leaves;
+    double max_error = (double)adaptive_tolerance * adaptive_tolerance;
+
+    for (int level = 1; level <= adaptive_depth && !nodes.empty(); level++) {
+        auto parent_key = [](const AdaptiveNode& node) {
+            return ((uint64_t)(node.z >> 1) << 42) | ((uint64_t)(node.y >> 1) << 21) | (uint64_t)(node.x >> 1);
+        };
+        std::sort(nodes.begin(), nodes.end(), [&](const AdaptiveNode& a, const AdaptiveNode& b) {
+            return parent_key(a) < parent_key(b);
+        });
+
+        std::vector<size_t> group_first;
+        for (size_t i = 0; i < nodes.size(); i++) {
+            if (i == 0 || parent_key(nodes[i]) != parent_key(nodes[i - 1])) {
+                group_first.push_back(i);
+            }
+        }
+        group_first.push_back(nodes.size());
+
+        size_t group_count = group_first.size() - 1;
+        std::vector<AdaptiveNode> parents(group_count);
+        int size = 1 << level;
+        int half = size >> 1;
+
+        parallel_for(0, group_count, [&](size_t begin, size_t end, size_t) {
+            for (size_t g = begin; g < end; g++) {
+                AdaptiveNode& parent = parents[g];
+                const AdaptiveNode& first = nodes[group_first[g]];
+                parent = {};
+                parent.x = first.x >> 1;
+                parent.y = first.y >> 1;
+                parent.z = first.z >> 1;
+                parent.leaf = true;
+                for (size_t i = group_first[g]; i < group_first[g + 1] && parent.leaf; i++) {
+                    parent.leaf = nodes[i].leaf;
+                    parent.qef.add(nodes[i].qef);
+                }
+                if (!parent.leaf) {
+                    continue;
+                }
+
+                double box_min[3] = { (double)parent.x * size, (double)parent.y * size, (double)parent.z * size };
+                double error = parent.qef.solve(box_min, size, parent.position);
+                if (error > max_error * parent.qef.count) {
+                    parent.leaf = false;
+                    continue;
+                }
+
+                bool outside[3][3][3];
+                for (int z = 0; z < 3; z++) {
+                    for (int y = 0; y < 3; y++) {
+                        for (int x = 0; x < 3; x++) {
+                            outside[z][y][x] = outside_at(parent.x * size + x * half, parent.y * size + y * half, parent.z * size + z * half);
+                        }
+                    }
+                }
+                parent.leaf = collapse_preserves_topology(outside);
+            }
+        }, 64);
+
+        // Los hijos de un padre que no se fusionó quedan como hojas definitivas
+        for (size_t g = 0; g < group_count; g++) {
+            if (parents[g].leaf) {
+                continue;
+            }
+            for (size_t i = group_first[g]; i < group_first[g + 1]; i++) {
+                if (nodes[i].leaf) {
+                    leaves.push_back({ level - 1, nodes[i] });
+                }
+            }
+        }
+        nodes.swap(parents);
+        if (level == adaptive_depth) {
+            for (const auto& node : nodes) {
+                if (node.leaf) {
+                    leaves.push_back({ level, node });
+                }
+            }
+        }
+    }
+    if (adaptive_depth <= 0) {
+        for (const auto& node : nodes) {
+            leaves.push_back({ 0, node });
+        }
+    }
+
+    // Cada celda fina apunta al vértice de la hoja que la contiene
+    MeshBuffers& buffers = mesh.buffers;
+    std::vector<uint32_t> cell_vertex((size_t)cells_x * cells_y * cells_z, UINT32_MAX);
+    for (const auto& leaf : leaves) {
+        const AdaptiveNode& node = leaf.node;
+        float normal[3] = { 0.0f, 0.0f, 0.0f };
+        if (normal_mode == NormalMode::Gradient) {
+            Point3DMC result = (Point3DMC((float)node.qef.normal[0], (float)node.qef.normal[1], (float)node.qef.normal[2]) * -1.0f).normalize();
+            normal[0] = result.x;
+            normal[1] = result.y;
+            normal[2] = result.z;
+        }
+        uint32_t vertex = buffers.add_vertex(
+            min_bounds.x + (float)node.position[0] * cell_size,
+            min_bounds.y + (float)node.position[1] * cell_size,
+            min_bounds.z + (float)node.position[2] * cell_size,
+            normal[0], normal[1], normal[2]
+        );
+
+        int size = 1 << leaf.level;
+        for (int z = node.z * size; z < std::min((node.z + 1) * size, cells_z); z++) {
+            for (int y = node.y * size; y < std::min((node.y + 1) * size, cells_y); y++) {
+                for (int x = node.x * size; x < std::min((node.x + 1) * size, cells_x); x++) {
+                    cell_vertex[((size_t)z * cells_y + y) * cells_x + x] = vertex;
+                }
+            }
+        }
+    }
+
+    std::cout << "Adaptive octree: " << leaves.size() << " leaves from " << fine_count << " active cells" << std::endl;
+    contour_dual_edges(mesh, cell_vertex);
+}
+
+size_t MarchingCubes::estimate_active_cells(float iso_level) {
+    // Se muestrea una de cada cuatro capas en Z y se escala el conteo
+    const int layer_step = 4;
+    size_t sampled_active = 0;
+    int sampled_layers = 0;
+
+    for (int z = 0; z < grid_size_z - 1; z += layer_step) {
+        sampled_layers++;
+        for (int y = 0; y < grid_size_y - 1; y++) {
+            for (int x = 0; x < grid_size_x - 1; x++) {
+                int below = 0;
+                for (int i = 0; i < 8; i++) {
+                    if (get_scalar_value(x + (int)cube_vertex_offset[i].x,
+                                         y + (int)cube_vertex_offset[i].y,
+                                         z + (int)cube_vertex_offset[i].z) < iso_level) {
+                        below++;
+                    }
+                }
+                if (below != 0 && below != 8) {
+                    sampled_active++;
+                }
+            }
+        }
+    }
+
+    if (sampled_layers == 0) {
+        return 0;
+    }
+    return sampled_active * (size_t)(grid_size_z - 1) / sampled_layers;
+}
+
+void MarchingCubes::generate_mesh(float iso_level) {
+    generate_mesh(std::vector<float>{ iso_level });
+}
+
+void MarchingCubes::generate_mesh(const std::vector<float>& iso_levels) {
+    clear_mesh();
+    meshes.reserve(iso_levels.size());
+
+    if (meshing_mode != MeshingMode::MarchingCubes) {
+        for (float iso_level : iso_levels) {
+            meshes.emplace_back(iso_level);
+            if (meshing_mode == MeshingMode::Adaptive) {
+                generate_adaptive_mesh(meshes.back());
+            } else {
+                generate_dual_mesh(meshes.back());
+            }
+            if (normal_mode == NormalMode::Face) {
+                meshes.back().buffers.compute_vertex_normals();
+            }
+            if (meshes.size() <= mapped_mesh_files.size() && !store_mapped_mesh(meshes.back(), mapped_mesh_files[meshes.size() - 1])) {
+                std::cerr << "Mapped output failed, keeping the mesh in memory" << std::endl;
+            }
+        }
+        std::cout << "Mesh generation complete."<< std::endl;
+        print_mesh_stats();
+        return;
+    }
+
+    for (float iso_level : iso_levels) {
+        meshes.emplace_back(iso_level);
+
+        // Cada celda activa aporta en promedio ~1 vértice nuevo y ~2 triángulos
+        size_t active_cells = estimate_active_cells(iso_level);
+        meshes.back().arena.reserve(active_cells + 1024, active_cells * 2 + 1024);
+    }
+
+    int last_progress = 0;
+    int z_begin = std::max(active_z_begin, 0);
+    int z_end = active_z_end < 0 ? grid_size_z - 1 : std::min(active_z_end, grid_size_z - 1);
+
+    // Por bricks los triángulos ya no quedan agrupados por capa y no se registra el inicio de cada una
+    bool by_bricks = field_layout == FieldLayout::Bricked && !keep_layer_order;
+
+    for_each_field_block(grid_size_x - 1, grid_size_y - 1, z_begin, z_end, by_bricks,
+                         [&](int x0, int x1, int y0, int y1, int z0, int z1) {
+        int layer_progress = ((z0 - z_begin) * 100) / (z_end - z_begin);
+        if (layer_progress != last_progress) {
+            std::cout << "Progress: " << layer_progress << "%" << std::endl;
+            last_progress = layer_progress;
+        }
+        if (!by_bricks) {
+            for (auto& mesh : meshes) {
+                mesh.layer_triangles.push_back((uint32_t)mesh.arena.triangles.size());
+            }
+        }
+        for (int z = z0; z < z1; z++) {
+            for (int y = y0; y < y1; y++) {
+                march_row(x0, x1, y, z);
+            }
+        }
+    });
+
+    for (size_t level = 0; level < meshes.size(); level++) {
+        MeshData& mesh = meshes[level];
+        if (!by_bricks) {
+            mesh.layer_triangles.push_back((uint32_t)mesh.arena.triangles.size());
+        }
+        if (level < mapped_mesh_files.size() && !keep_vertex_keys) {
+            if (store_mapped_mesh(mesh, mapped_mesh_files[level])) {
+                continue;
+            }
+            std::cerr << "Mapped output failed, keeping the mesh in memory" << std::endl;
+        }
+        mesh.arena.flatten_into(mesh.buffers);
+        if (keep_vertex_keys) {
+            mesh.arena.lookup.keys_by_value(mesh.vertex_keys);
+        }
+        mesh.arena.clear();
+        if (normal_mode == NormalMode::Face) {
+            mesh.buffers.compute_vertex_normals();
+        }
+    }
+    std::cout << "Mesh generation complete."<< std::endl;
+    print_mesh_stats();
+}
+
+// Copia la malla (desde la arena de Marching Cubes o desde los buffers de los métodos duales) a su .rmesh
+// mapeado; las normales de caras de la arena se calculan directamente dentro del archivo. La memoria de la
+// malla se libera solo cuando el archivo quedó escrito: si no se puede mapear o escribir, la malla sigue en
+// memoria y se exporta de la forma habitual
+bool MarchingCubes::store_mapped_mesh(MeshData& mesh, const std::string& filename) {
+    bool from_arena = mesh.buffers.positions.empty();
+    size_t vertex_count = from_arena ? mesh.arena.positions.size() : mesh.buffers.vertex_count();
+    size_t index_count = from_arena ? mesh.arena.triangles.size() * 3 : mesh.buffers.indices.size();
+
+    MappedFile file;
+    if (!create_mapped_native_mesh(filename, vertex_count, index_count, file)) {
+        return false;
+    }
+    NativeMeshHeader header;
+    std::memcpy(&header, file.data(), sizeof(header));
+    float* positions = reinterpret_cast<float*>(file.mutable_data() + header.positions_offset);
+    float* normals = reinterpret_cast<float*>(file.mutable_data() + header.normals_offset);
+    uint32_t* indices = reinterpret_cast<uint32_t*>(file.mutable_data() + header.indices_offset);
+
+    if (from_arena) {
+        mesh.arena.positions.copy_to(positions);
+        mesh.arena.triangles.copy_to(indices);
+        if (normal_mode == NormalMode::Face) {
+            compute_vertex_normals(positions, vertex_count, indices, index_count, normals);
+        } else {
+            mesh.arena.normals.copy_to(normals);
+        }
+    } else {
+        std::memcpy(positions, mesh.buffers.positions.data(), vertex_count * 3 * sizeof(float));
+        std::memcpy(normals, mesh.buffers.normals.data(), vertex_count * 3 * sizeof(float));
+        std::memcpy(indices, mesh.buffers.indices.data(), index_count * sizeof(uint32_t));
+    }
+
+    // La malla en memoria solo se libera cuando el archivo quedó escrito
+    if (!finish_mapped_native_mesh(file)) {
+        std::cerr << "Error writing mapped mesh: " << filename << std::endl;
+        std::remove(filename.c_str());
+        return false;
+    }
+    if (from_arena) {
+        mesh.arena.clear();
+    } else {
+        mesh.buffers = MeshBuffers();
+    }
+    mesh.mapped_file = filename;
+    mesh.mapped_vertices = vertex_count;
+    mesh.mapped_triangles = index_count / 3;
+    return true;
+}
+
+void MarchingCubes::process_point_cloud(const std::string& file_cloud, float iso_level) {
+    process_point_cloud(file_cloud, std::vector<float>{ iso_level });
+}
+
+// Carga el campo desde la caché si coincide con la entrada; si no, lo calcula y lo guarda
+void MarchingCubes::prepare_scalar_field(const std::string& cache_name, uint64_t input_hash, const std::vector<float>& iso_levels) {
+    std::string cache_file;
+    if (!cache_directory.empty() && !cache_name.empty()) {
+        cache_file = cache_directory + "/" + cache_name + ".field";
+    }
+
+    // El campo muestreado sobre el octree depende de los niveles iso y de la profundidad
+    if (meshing_mode == MeshingMode::Adaptive && !iso_levels.empty()) {
+        input_hash = hash_bytes(reinterpret_cast<const uint8_t*>(iso_levels.data()), iso_levels.size() * sizeof(float), input_hash);
+        input_hash = hash_bytes(reinterpret_cast<const uint8_t*>(&adaptive_depth), sizeof(adaptive_depth), input_hash);
+    }
+
+    if (cache_file.empty() || !load_field_cache(cache_file, input_hash)) {
+        if (mapped_storage && !cache_file.empty() && calculate_mapped_field(cache_file, input_hash, iso_levels)) {
+            return;
+        }
+        calculate_scalar_field(iso_levels);
+        if (!cache_file.empty() && save_field_cache(cache_file, input_hash)) {
+            std::cout << "Scalar field cached to: " << cache_file << std::endl;
+        }
+    }
+}
+
+void MarchingCubes::process_point_cloud(const std::string& file_cloud, const std::vector<float>& iso_levels) {
+    if (!load_points_cloud(file_cloud)) {
+        return;
+    }
+
+    initialize_grid();
+
+    uint64_t input_hash = 0;
+    std::string cache_name;
+    if (!cache_directory.empty() && hash_file_contents(file_cloud, input_hash)) {
+        std::string stem = file_cloud.substr(file_cloud.find_last_of("/\\") + 1);
+        cache_name = stem.substr(0, stem.find_last_of('.'));
+    }
+
+    prepare_scalar_field(cache_name, input_hash, iso_levels);
+    generate_mesh(iso_levels);
+}
+
+void MarchingCubes::process_points(const Point3D* points, size_t count, const std::vector<float>& iso_levels, const std::string& cache_name) {
+    set_points(points, count);
+    if (point_cloud.empty()) {
+        std::cerr << "Point cloud is empty." << std::endl;
+        return;
+    }
+
+    initialize_grid();
+
+    uint64_t input_hash = 0;
+    if (!cache_name.empty()) {
+        input_hash = hash_bytes(reinterpret_cast<const uint8_t*>(points), count * sizeof(Point3D));
+    }
+
+    prepare_scalar_field(cache_name, input_hash, iso_levels);
+    generate_mesh(iso_levels);
+}
+
+// Un parche por cada órgano presente en las esquinas; el vértice queda en el punto medio de la arista,
+// así dos órganos en contacto generan exactamente la misma costura
+void MarchingCubes::process_label_cell(int x, int y, int z, const uint8_t labels[8], int stride) {
+    uint8_t done[8];
+    int done_count = 0;
+
+    for (int c = 0; c < 8; c++) {
+        uint8_t label = labels[c];
+        if (label == 0 || std::find(done, done + done_count, label) != done + done_count) {
+            continue;
+        }
+        done[done_count++] = label;
+
+        int cube_index = 0;
+        for (int i = 0; i < 8; i++) {
+            if (labels[i] != label) {
+                cube_index |= (1 << i);
+            }
+        }
+        const CubeCase& cube_case = cube_cases[cube_index];
+        if (cube_case.triangle_count == 0) {
+            continue;
+        }
+
+        MeshData& mesh = meshes[label - 1];
+        Point3DMC vertex_list[12];
+        uint64_t key_list[12];
+        for (int e = 0; e < cube_case.edge_count; e++) {
+            int i = cube_case.edges[e];
+            const Point3DMC& a = cube_vertex_offset[edge_index_pairs[i][0]];
+            const Point3DMC& b = cube_vertex_offset[edge_index_pairs[i][1]];
+            vertex_list[i] = Point3DMC(
+                min_bounds.x + (x + (a.x + b.x) * 0.5f) * stride,
+                min_bounds.y + (y + (a.y + b.y) * 0.5f) * stride,
+                min_bounds.z + (z + (a.z + b.z) * 0.5f) * stride
+            );
+            key_list[i] = edge_vertex_key(x, y, z, i, 0.5f);
+        }
+
+        for (int t = 0; t < cube_case.triangle_count * 3; t += 3) {
+            uint32_t triangle[3];
+            for (int j = 0; j < 3; j++) {
+                int edge = cube_case.triangles[t + j];
+                triangle[j] = add_or_find_vertex(mesh, key_list[edge], vertex_list[edge], Point3DMC());
+            }
+            mesh.arena.add_triangle(triangle[0], triangle[1], triangle[2]);
+        }
+    }
+}
+
+// Todas las etiquetas se recorren en una sola pasada: una malla por etiqueta, en el orden de volume.names
+void MarchingCubes::process_label_volume(const LabelVolume& volume, int stride) {
+    clear_mesh();
+    stride = std::max(stride, 1);
+    if (volume.labels.empty() || volume.names.empty()) {
+        std::cerr << "Label volume is empty." << std::endl;
+        return;
+    }
+
+    // Una muestra de fondo alrededor del volumen cierra las superficies que tocan el borde
+    grid_size_x = (volume.width + stride - 1) / stride + 2;
+    grid_size_y = (volume.height + stride - 1) / stride + 2;
+    grid_size_z = (volume.depth + stride - 1) / stride + 2;
+    min_bounds = Point3DMC(-(float)stride, 1.0f - stride, -(float)stride);
+    max_bounds = min_bounds + Point3DMC((float)grid_size_x - 1, (float)grid_size_y - 1, (float)grid_size_z - 1) * (float)stride;
+    scalar_field.clear();
+    field_cache_file.close();
+    field_values = nullptr;
+
+    std::cout << "Label grid initialized with dimensions: "
+              << grid_size_x << " x " << grid_size_y << " x " << grid_size_z
+              << " and stride: " << stride << std::endl;
+
+    std::vector<uint8_t> samples((size_t)grid_size_x * grid_size_y * grid_size_z);
+    parallel_for(0, grid_size_z, [&](size_t begin, size_t end, size_t) {
+        for (int z = (int)begin; z < (int)end; z++) {
+            for (int y = 0; y < grid_size_y; y++) {
+                for (int x = 0; x < grid_size_x; x++) {
+                    samples[field_index(x, y, z)] = volume.at((x - 1) * stride, (y - 1) * stride, (z - 1) * stride);
+                }
+            }
+        }
+    }, 1);
+
+    // Bloques de 8x8x8 celdas con una sola etiqueta en todas sus muestras no generan nada y se saltan
+    const int block = 8;
+    int blocks_x = (grid_size_x - 2) / block + 1;
+    int blocks_y = (grid_size_y - 2) / block + 1;
+    int blocks_z = (grid_size_z - 2) / block + 1;
+    std::vector<uint8_t> active_blocks((size_t)blocks_x * blocks_y * blocks_z, 0);
+    parallel_for(0, blocks_z, [&](size_t begin, size_t end, size_t) {
+        for (int bz = (int)begin; bz < (int)end; bz++) {
+            for (int by = 0; by < blocks_y; by++) {
+                for (int bx = 0; bx < blocks_x; bx++) {
+                    uint8_t first = samples[field_index(bx * block, by * block, bz * block)];
+                    bool active = false;
+                    for (int z = bz * block; z <= std::min(bz * block + block, grid_size_z - 1) && !active; z++) {
+                        for (int y = by * block; y <= std::min(by * block + block, grid_size_y - 1) && !active; y++) {
+                            for (int x = bx * block; x <= std::min(bx * block + block, grid_size_x - 1); x++) {
+                                if (samples[field_index(x, y, z)] != first) {
+                                    active = true;
+                                    break;
+                                }
+                            }
+                        }
+                    }
+                    active_blocks[((size_t)bz * blocks_y + by) * blocks_x + bx] = active;
+                }
+            }
+        }
+    }, 1);
+
+    for (const auto& name : volume.names) {
+        meshes.emplace_back();
+        meshes.back().label = name;
+    }
+
+    int last_progress = 0;
+    for (int bz = 0; bz < blocks_z; bz++) {
+        int layer_progress = (bz * 100) / blocks_z;
+        if (layer_progress != last_progress) {
+            std::cout << "Progress: " << layer_progress << "%" << std::endl;
+            last_progress = layer_progress;
+        }
+        for (int by = 0; by < blocks_y; by++) {
+            for (int bx = 0; bx < blocks_x; bx++) {
+                if (!active_blocks[((size_t)bz * blocks_y + by) * blocks_x + bx]) {
+                    continue;
+                }
+                for (int z = bz * block; z < std::min(bz * block + block, grid_size_z - 1); z++) {
+                    for (int y = by * block; y < std::min(by * block + block, grid_size_y - 1); y++) {
+                        for (int x = bx * block; x < std::min(bx * block + block, grid_size_x - 1); x++) {
+                            uint8_t labels[8];
+                            bool uniform = true;
+                            for (int i = 0; i < 8; i++) {
+                                labels[i] = samples[field_index(
+                                    x + (int)cube_vertex_offset[i].x,
+                                    y + (int)cube_vertex_offset[i].y,
+                                    z + (int)cube_vertex_offset[i].z
+                                )];
+                                uniform = uniform && labels[i] == labels[0];
+                            }
+                            if (!uniform) {
+                                process_label_cell(x, y, z, labels, stride);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // Las etiquetas no tienen gradiente: las normales siempre salen de las caras
+    for (auto& mesh : meshes) {
+        mesh.arena.flatten_into(mesh.buffers);
+        mesh.arena.clear();
+        mesh.buffers.compute_vertex_normals();
+    }
+    std::cout << "Mesh generation complete."<< std::endl;
+    print_mesh_stats();
+}
+
+// Recorre el archivo en tramos de ~block_bytes cortados en saltos de línea; solo un tramo vive en memoria
+template <typename Visit>
+static void for_each_xyz_block(const MappedFile& file, size_t block_bytes, Visit visit) {
+    const char* data = reinterpret_cast<const char*>(file.data());
+    size_t size = file.size();
+    std::vector<Point3DMC> points;
+
+    size_t start = 0;
+    while (start < size) {
+        size_t end = std::min(size, start + block_bytes);
+        if (end < size) {
+            const char* newline = static_cast<const char*>(std::memchr(data + end, '\n', size - end));
+            end = newline == nullptr ? size : (size_t)(newline - data) + 1;
+        }
+        points.clear();
+        parse_xyz_text(data + start, end - start, points);
+        visit(points);
+        start = end;
+    }
+}
+
+// Modo por bloques: la malla se divide en losas de capas Z que caben en el presupuesto de memoria.
+// Cada losa relee del archivo solo los puntos a menos de influence_radius, calcula su campo con una capa
+// extra a cada lado para los gradientes y escribe su malla con las claves globales de arista en chunk_files
+// Con slab_count > 1 solo se generan las capas de la losa slab_index; así varios procesos se reparten la malla
+bool MarchingCubes::process_point_cloud_chunked(const std::string& file_cloud, const std::vector<float>& iso_levels,
+                                                size_t memory_budget, const std::vector<std::string>& chunk_files,
+                                                int slab_index, int slab_count) {
+    if (chunk_files.size() != iso_levels.size()) {
+        std::cerr << "One chunk file per iso level is required." << std::endl;
+        return false;
+    }
+
+    MappedFile file;
+    if (!file.open_read(file_cloud)) {
+        std::cerr << "Error opening file: " << file_cloud << std::endl;
+        return false;
+    }
+    size_t block_bytes = std::max<size_t>(1 << 20, std::min<size_t>(64 << 20, memory_budget / 8));
+
+    // Primera pasada: solo los límites, sin guardar los puntos
+    size_t total_points = 0;
+    for_each_xyz_block(file, block_bytes, [&](const std::vector<Point3DMC>& points) {
+        for (const auto& point : points) {
+            if (total_points++ == 0) {
+                min_bounds = max_bounds = point;
+            }
+            min_bounds.x = std::min(min_bounds.x, point.x);
+            min_bounds.y = std::min(min_bounds.y, point.y);
+            min_bounds.z = std::min(min_bounds.z, point.z);
+            max_bounds.x = std::max(max_bounds.x, point.x);
+            max_bounds.y = std::max(max_bounds.y, point.y);
+            max_bounds.z = std::max(max_bounds.z, point.z);
+        }
+    });
+    if (total_points == 0) {
+        std::cerr << "Point cloud is empty." << std::endl;
+        return false;
+    }
+    pad_bounds();
+    size_grid_to_bounds();
+
+    // La mitad del presupuesto es para el campo de la losa; el resto para sus puntos y su malla
+    Point3DMC global_min = min_bounds;
+    int global_size_z = grid_size_z;
+    int total_cells_z = global_size_z - 1;
+    slab_count = std::max(slab_count, 1);
+    int slab_first = (int)((int64_t)total_cells_z * slab_index / slab_count);
+    int slab_last = (int)((int64_t)total_cells_z * (slab_index + 1) / slab_count);
+
+    // Sin presupuesto la losa completa es un solo bloque
+    size_t layer_bytes = (size_t)grid_size_x * grid_size_y * sizeof(float);
+    int cell_layers = slab_last - slab_first;
+    if (memory_budget > 0) {
+        // Un bloque necesita al menos una capa de celdas más las tres capas extra del campo
+        size_t budget_layers = memory_budget / 2 / layer_bytes;
+        if (budget_layers < 4) {
+            size_t needed_mb = (8 * layer_bytes + (1 << 20) - 1) >> 20;
+            std::cerr << "Error: memory budget of " << (memory_budget >> 20) << " MB is too small for one XY layer of "
+                      << grid_size_x << "x" << grid_size_y << " samples, at least " << needed_mb << " MB are needed" << std::endl;
+            return false;
+        }
+        cell_layers = std::min(cell_layers, (int)std::min<size_t>(budget_layers, INT32_MAX) - 3);
+    }
+    cell_layers = std::max(cell_layers, 1);
+    int chunk_count = (slab_last - slab_first + cell_layers - 1) / cell_layers;
+    std::cout << "Chunked meshing: " << total_points << " points in " << chunk_count << " chunks of "
+              << cell_layers << " layers (budget " << (memory_budget >> 20) << " MB)" << std::endl;
+    if (slab_count > 1) {
+        std::cout << "Slab " << slab_index + 1 << "/" << slab_count << ": layers " << slab_first << "-" << slab_last << std::endl;
+    }
+
+    std::vector<ChunkedMeshWriter> writers(iso_levels.size());
+    for (size_t level = 0; level < writers.size(); level++) {
+        if (!writers[level].open(chunk_files[level])) {
+            return false;
+        }
+    }
+
+    // Las normales de las caras quedarían cortadas en las costuras; las del gradiente coinciden en ambos lados
+    NormalMode saved_normal_mode = normal_mode;
+    MeshingMode saved_meshing_mode = meshing_mode;
+    normal_mode = NormalMode::Gradient;
+    meshing_mode = MeshingMode::MarchingCubes;
+    keep_vertex_keys = true;
+
+    bool success = true;
+    for (int chunk = 0; chunk < chunk_count && success; chunk++) {
+        int z0 = slab_first + chunk * cell_layers;
+        int z1 = std::min(z0 + cell_layers, slab_last);
+        int first_layer = std::max(z0 - 1, 0);
+        int last_layer = std::min(z1 + 1, global_size_z - 1);
+        float z_low = global_min.z + first_layer * cell_size - influence_radius;
+        float z_high = global_min.z + last_layer * cell_size + influence_radius;
+
+        point_cloud.clear();
+        for_each_xyz_block(file, block_bytes, [&](const std::vector<Point3DMC>& points) {
+            for (const auto& point : points) {
+                if (point.z >= z_low && point.z <= z_high) {
+                    point_cloud.push_back(point);
+                }
+            }
+        });
+        std::cout << "Chunk " << chunk + 1 << "/" << chunk_count << ": layers " << z0 << "-" << z1
+                  << ", " << point_cloud.size() << " points" << std::endl;
+
+        min_bounds.z = global_min.z + first_layer * cell_size;
+        grid_size_z = last_layer - first_layer + 1;
+        active_z_begin = z0 - first_layer;
+        active_z_end = z1 - first_layer;
+
+        calculate_scalar_field();
+        generate_mesh(iso_levels);
+
+        // Las claves locales se desplazan a la numeración de la malla completa
+        uint64_t key_offset = (uint64_t)first_layer * grid_size_x * grid_size_y * 4;
+        for (size_t level = 0; level < meshes.size(); level++) {
+            for (auto& key : meshes[level].vertex_keys) {
+                key += key_offset;
+            }
+            success = success && writers[level].write_chunk(meshes[level].buffers, meshes[level].vertex_keys);
+        }
+        clear_mesh();
+    }
+
+    for (auto& writer : writers) {
+        success = writer.close() && success;
+    }
+
+    normal_mode = saved_normal_mode;
+    meshing_mode = saved_meshing_mode;
+    keep_vertex_keys = false;
+    active_z_begin = 0;
+    active_z_end = -1;
+    min_bounds = global_min;
+    grid_size_z = global_size_z;
+    point_cloud.clear();
+    std::vector<Point3DMC>().swap(point_cloud);
+    scalar_field.clear();
+    std::vector<float>().swap(scalar_field);
+    field_values = nullptr;
+    return success;
+}
+
+// Hash de los puntos de cada corte Z; los puntos de un mismo corte llegan contiguos desde la extracción
+static std::vector<uint64_t> compute_slice_hashes(const Point3D* points, size_t count) {
+    std::vector<uint64_t> hashes;
+    size_t run = 0;
+    while (run < count) {
+        size_t run_end = run;
+        while (run_end < count && points[run_end].coordinate_z == points[run].coordinate_z) {
+            run_end++;
+        }
+        int z = std::max(points[run].coordinate_z, 0);
+        if ((size_t)z >= hashes.size()) {
+            hashes.resize((size_t)z + 1, 0);
+        }
+        hashes[z] = hash_bytes(reinterpret_cast<const uint8_t*>(points + run), (run_end - run) * sizeof(Point3D), hashes[z] ^ 14695981039346656037ull);
+        run = run_end;
+    }
+    return hashes;
+}
+
+bool MarchingCubes::save_incremental_state(const std::string& state_file, const std::vector<uint64_t>& slice_hashes, uint64_t input_hash) const {
+    std::ofstream file(state_file, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Error opening state file for writing: " << state_file << std::endl;
+        return false;
+    }
+
+    IncrementalStateHeader header = {};
+    std::memcpy(header.magic, "RC3DINC\0", 8);
+    header.version = incremental_state_version;
+    header.level_count = (uint32_t)meshes.size();
+    header.slice_count = (uint32_t)slice_hashes.size();
+    header.normal_mode = (uint32_t)normal_mode;
+    header.input_hash = input_hash;
+    header.cell_size = cell_size;
+    header.influence_radius = influence_radius;
+    header.grid_size_x = grid_size_x;
+    header.grid_size_y = grid_size_y;
+    header.grid_size_z = grid_size_z;
+    header.min_bounds[0] = min_bounds.x;
+    header.min_bounds[1] = min_bounds.y;
+    header.min_bounds[2] = min_bounds.z;
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(slice_hashes.data()), (std::streamsize)(slice_hashes.size() * sizeof(uint64_t)));
+
+    for (const auto& mesh : meshes) {
+        IncrementalLevelHeader level = {};
+        level.iso_level = mesh.iso_level;
+        level.vertex_count = mesh.buffers.vertex_count();
+        level.index_count = mesh.buffers.indices.size();
+        level.layer_count = mesh.layer_triangles.size();
+        file.write(reinterpret_cast<const char*>(&level), sizeof(level));
+        file.write(reinterpret_cast<const char*>(mesh.buffers.positions.data()), (std::streamsize)(mesh.buffers.positions.size() * sizeof(float)));
+        file.write(reinterpret_cast<const char*>(mesh.buffers.normals.data()), (std::streamsize)(mesh.buffers.normals.size() * sizeof(float)));
+        file.write(reinterpret_cast<const char*>(mesh.vertex_keys.data()), (std::streamsize)(mesh.vertex_keys.size() * sizeof(uint64_t)));
+        file.write(reinterpret_cast<const char*>(mesh.buffers.indices.data()), (std::streamsize)(mesh.buffers.indices.size() * sizeof(uint32_t)));
+        file.write(reinterpret_cast<const char*>(mesh.layer_triangles.data()), (std::streamsize)(mesh.layer_triangles.size() * sizeof(uint32_t)));
+    }
+    return file.good();
+}
+
+// Solo se acepta un estado generado con la misma malla, kernel, normales y niveles iso
+bool MarchingCubes::load_incremental_state(const std::string& state_file, const std::vector<float>& iso_levels,
+                                           std::vector<uint64_t>& slice_hashes, uint64_t& input_hash) {
+    MappedFile file;
+    if (!file.open_read(state_file) || file.size() < sizeof(IncrementalStateHeader)) {
+        return false;
+    }
+
+    IncrementalStateHeader header;
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (std::memcmp(header.magic, "RC3DINC\0", 8) != 0 || header.version != incremental_state_version ||
+        header.level_count != iso_levels.size() || header.normal_mode != (uint32_t)normal_mode ||
+        header.cell_size != cell_size || header.influence_radius != influence_radius ||
+        header.grid_size_x != grid_size_x || header.grid_size_y != grid_size_y || header.grid_size_z != grid_size_z ||
+        header.min_bounds[0] != min_bounds.x || header.min_bounds[1] != min_bounds.y || header.min_bounds[2] != min_bounds.z) {
+        return false;
+    }
+
+    const uint8_t* cursor = file.data() + sizeof(header);
+    const uint8_t* end = file.data() + file.size();
+    auto read = [&](void* destination, size_t bytes) {
+        if ((size_t)(end - cursor) < bytes) {
+            return false;
+        }
+        std::memcpy(destination, cursor, bytes);
+        cursor += bytes;
+        return true;
+    };
+
+    slice_hashes.resize(header.slice_count);
+    if (!read(slice_hashes.data(), slice_hashes.size() * sizeof(uint64_t))) {
+        return false;
+    }
+    input_hash = header.input_hash;
+
+    clear_mesh();
+    for (uint32_t l = 0; l < header.level_count; l++) {
+        IncrementalLevelHeader level;
+        if (!read(&level, sizeof(level)) || level.iso_level != iso_levels[l] ||
+            level.layer_count != (uint64_t)grid_size_z) {
+            clear_mesh();
+            return false;
+        }
+
+        meshes.emplace_back(level.iso_level);
+        MeshData& mesh = meshes.back();
+        mesh.buffers.positions.resize((size_t)level.vertex_count * 3);
+        mesh.buffers.normals.resize((size_t)level.vertex_count * 3);
+        mesh.vertex_keys.resize((size_t)level.vertex_count);
+        mesh.buffers.indices.resize((size_t)level.index_count);
+        mesh.layer_triangles.resize((size_t)level.layer_count);
+        if (!read(mesh.buffers.positions.data(), mesh.buffers.positions.size() * sizeof(float)) ||
+            !read(mesh.buffers.normals.data(), mesh.buffers.normals.size() * sizeof(float)) ||
+            !read(mesh.vertex_keys.data(), mesh.vertex_keys.size() * sizeof(uint64_t)) ||
+            !read(mesh.buffers.indices.data(), mesh.buffers.indices.size() * sizeof(uint32_t)) ||
+            !read(mesh.layer_triangles.data(), mesh.layer_triangles.size() * sizeof(uint32_t))) {
+            clear_mesh();
+            return false;
+        }
+    }
+    return true;
+}
+
+// Vuelve a recorrer solo las capas de celdas marcadas. Los triángulos de las demás capas se copian en orden
+// y los vértices de aristas cuyos extremos no cambiaron se reutilizan, así la costura queda cerrada
+void MarchingCubes::remesh_layers(const std::vector<uint8_t>& dirty_cells, const std::vector<uint8_t>& changed_layers) {
+    size_t layer_size = (size_t)grid_size_x * grid_size_y;
+    auto reusable = [&](uint64_t key) {
+        size_t layer = (size_t)(key >> 2) / layer_size;
+        bool z_edge = (key & 3) == 2;
+        return !changed_layers[layer] && !(z_edge && changed_layers[layer + 1]);
+    };
+
+    std::vector<MeshBuffers> old_buffers(meshes.size());
+    std::vector<std::vector<uint64_t>> old_keys(meshes.size());
+    std::vector<std::vector<uint32_t>> old_layers(meshes.size());
+    for (size_t l = 0; l < meshes.size(); l++) {
+        MeshData& mesh = meshes[l];
+        old_buffers[l] = std::move(mesh.buffers);
+        old_keys[l] = std::move(mesh.vertex_keys);
+        old_layers[l] = std::move(mesh.layer_triangles);
+        mesh.buffers.clear();
+        mesh.vertex_keys.clear();
+        mesh.layer_triangles.clear();
+
+        const MeshBuffers& old = old_buffers[l];
+        mesh.arena.clear();
+        mesh.arena.reserve(old.vertex_count() + 1024, old.triangle_count() + 1024);
+        for (size_t v = 0; v < old.vertex_count(); v++) {
+            uint32_t index = mesh.arena.add_vertex(&old.positions[v * 3], &old.normals[v * 3]);
+            if (reusable(old_keys[l][v])) {
+                uint32_t found;
+                mesh.arena.lookup.find_or_insert(old_keys[l][v], index, found);
+            }
+        }
+    }
+
+    for (int z = 0; z < grid_size_z - 1; z++) {
+        for (size_t l = 0; l < meshes.size(); l++) {
+            meshes[l].layer_triangles.push_back((uint32_t)meshes[l].arena.triangles.size());
+        }
+        if (dirty_cells[z]) {
+            for (int y = 0; y < grid_size_y - 1; y++) {
+                march_row(0, grid_size_x - 1, y, z);
+            }
+            continue;
+        }
+        for (size_t l = 0; l < meshes.size(); l++) {
+            const std::vector<uint32_t>& indices = old_buffers[l].indices;
+            for (uint32_t t = old_layers[l][z]; t < old_layers[l][z + 1]; t++) {
+                meshes[l].arena.add_triangle(indices[t * 3], indices[t * 3 + 1], indices[t * 3 + 2]);
+            }
+        }
+    }
+
+    for (size_t l = 0; l < meshes.size(); l++) {
+        MeshData& mesh = meshes[l];
+        mesh.layer_triangles.push_back((uint32_t)mesh.arena.triangles.size());
+
+        // Las claves de los vértices nuevos vienen de la tabla; las de los anteriores se conservan
+        std::vector<uint64_t> keys;
+        mesh.arena.lookup.keys_by_value(keys);
+        keys.resize(mesh.arena.positions.size(), ~0ull);
+        for (size_t v = 0; v < old_keys[l].size(); v++) {
+            keys[v] = old_keys[l][v];
+        }
+        mesh.arena.flatten_into(mesh.buffers);
+        mesh.arena.clear();
+
+        // Los vértices que solo usaban los triángulos reemplazados se eliminan sin cambiar el orden del resto
+        MeshBuffers& buffers = mesh.buffers;
+        std::vector<uint32_t> remap(buffers.vertex_count(), UINT32_MAX);
+        for (uint32_t index : buffers.indices) {
+            remap[index] = 0;
+        }
+        uint32_t kept = 0;
+        for (size_t v = 0; v < remap.size(); v++) {
+            if (remap[v] == UINT32_MAX) {
+                continue;
+            }
+            remap[v] = kept;
+            for (int k = 0; k < 3; k++) {
+                buffers.positions[kept * 3 + k] = buffers.positions[v * 3 + k];
+                buffers.normals[kept * 3 + k] = buffers.normals[v * 3 + k];
+            }
+            keys[kept] = keys[v];
+            kept++;
+        }
+        buffers.positions.resize((size_t)kept * 3);
+        buffers.normals.resize((size_t)kept * 3);
+        keys.resize(kept);
+        for (auto& index : buffers.indices) {
+            index = remap[index];
+        }
+        mesh.vertex_keys = std::move(keys);
+
+        if (normal_mode == NormalMode::Face) {
+            buffers.compute_vertex_normals();
+        }
+    }
+}
+
+// Compara los cortes con el índice guardado en la caché y, si la malla no cambió de tamaño, recalcula solo
+// las capas del campo a menos de influence_radius de los cortes modificados y vuelve a recorrer sus celdas
+void MarchingCubes::process_points_incremental(const Point3D* points, size_t count, const std::vector<float>& iso_levels, const std::string& state_name) {
+    set_points(points, count);
+    if (point_cloud.empty()) {
+        std::cerr << "Point cloud is empty." << std::endl;
+        return;
+    }
+    initialize_grid();
+
+    std::vector<uint64_t> slice_hashes = compute_slice_hashes(points, count);
+    uint64_t input_hash = hash_bytes(reinterpret_cast<const uint8_t*>(points), count * sizeof(Point3D));
+    std::string state_file = cache_directory.empty() ? state_name + ".state" : cache_directory + "/" + state_name + ".state";
+    std::string field_file = cache_directory.empty() ? state_name + ".field" : cache_directory + "/" + state_name + ".field";
+
+    MeshingMode saved_meshing_mode = meshing_mode;
+    meshing_mode = MeshingMode::MarchingCubes;
+    keep_vertex_keys = true;
+    keep_layer_order = true;
+
+    std::vector<uint64_t> old_hashes;
+    uint64_t old_input_hash = 0;
+    bool incremental = load_incremental_state(state_file, iso_levels, old_hashes, old_input_hash) &&
+                       load_field_cache(field_file, old_input_hash);
+
+    if (!incremental) {
+        std::cout << "No reusable incremental state, full rebuild" << std::endl;
+        prepare_scalar_field(state_name, input_hash, iso_levels);
+        generate_mesh(iso_levels);
+    } else {
+        std::vector<int> dirty_slices;
+        for (size_t z = 0; z < std::max(slice_hashes.size(), old_hashes.size()); z++) {
+            uint64_t now = z < slice_hashes.size() ? slice_hashes[z] : 0;
+            uint64_t before = z < old_hashes.size() ? old_hashes[z] : 0;
+            if (now != before) {
+                dirty_slices.push_back((int)z);
+            }
+        }
+        std::cout << "Incremental update: " << dirty_slices.size() << " of " << slice_hashes.size() << " slices changed" << std::endl;
+
+        if (!dirty_slices.empty()) {
+            // El campo mapeado de la caché se copia para poder reescribir solo las capas afectadas
+            scalar_field.assign(field_values, field_values + field_storage_size());
+            field_cache_file.close();
+            field_values = scalar_field.data();
+
+            std::vector<uint8_t> changed_field(grid_size_z + 1, 0);
+            for (int slice : dirty_slices) {
+                int first = std::max(0, (int)std::ceil((slice - influence_radius - min_bounds.z) / cell_size));
+                int last = std::min(grid_size_z - 1, (int)std::floor((slice + influence_radius - min_bounds.z) / cell_size));
+                for (int k = first; k <= last; k++) {
+                    changed_field[k] = 1;
+                }
+            }
+            for (int k = 0; k < grid_size_z; k++) {
+                if (changed_field[k] && (k == 0 || !changed_field[k - 1])) {
+                    int run_end = k;
+                    while (run_end < grid_size_z && changed_field[run_end]) {
+                        run_end++;
+                    }
+                    calculate_field_layers(scalar_field.data(), k, run_end);
+                }
+            }
+
+            // Los gradientes usan las capas vecinas: los vértices a una capa de distancia también cambian
+            std::vector<uint8_t> changed_layers(grid_size_z + 1, 0);
+            for (int k = 0; k < grid_size_z; k++) {
+                changed_layers[k] = changed_field[k] || (k > 0 && changed_field[k - 1]) || changed_field[k + 1];
+            }
+            std::vector<uint8_t> dirty_cells(grid_size_z, 0);
+            int dirty_count = 0;
+            for (int z = 0; z < grid_size_z - 1; z++) {
+                dirty_cells[z] = changed_layers[z] || changed_layers[z + 1];
+                dirty_count += dirty_cells[z];
+            }
+            std::cout << "Re-marching " << dirty_count << " of " << grid_size_z - 1 << " cell layers" << std::endl;
+
+            remesh_layers(dirty_cells, changed_layers);
+            if (!field_file.empty() && save_field_cache(field_file, input_hash)) {
+                std::cout << "Scalar field cached to: " << field_file << std::endl;
+            }
+        }
+        print_mesh_stats();
+    }
+
+    if (save_incremental_state(state_file, slice_hashes, input_hash)) {
+        std::cout << "Incremental state saved to: " << state_file << std::endl;
+    }
+    keep_vertex_keys = false;
+    keep_layer_order = false;
+    meshing_mode = saved_meshing_mode;
+}
+
+void MarchingCubes::clear_mesh() {
+    meshes.clear();
+}
+
+size_t MarchingCubes::get_mesh_count() const {
+    return meshes.size();
+}
+
+float MarchingCubes::get_iso_level(size_t level) const {
+    return meshes.at(level).iso_level;
+}
+
+const std::string& MarchingCubes::get_label(size_t level) const {
+    return meshes.at(level).label;
+}
+
+// Archivo .rmesh donde quedó escrita la malla con salida mapeada (vacío si sigue en memoria)
+const std::string& MarchingCubes::get_mapped_file(size_t level) const {
+    return meshes.at(level).mapped_file;
+}
+
+const MeshBuffers& MarchingCubes::get_mesh(size_t level) const {
+    return meshes.at(level).buffers;
+}
+
+MeshBuffers MarchingCubes::take_mesh(size_t level) {
+    return std::move(meshes.at(level).buffers);
+}
+
+void MarchingCubes::print_mesh_stats() const {
+    std::cout << "Mesh Statistics:" << std::endl;
+    for (const auto& mesh : meshes) {
+        if (!mesh.label.empty()) {
+            std::cout << "Label: " << mesh.label << std::endl;
+        } else if (meshes.size() > 1) {
+            std::cout << "Iso level: " << mesh.iso_level << std::endl;
+        }
+        if (!mesh.mapped_file.empty()) {
+            std::cout << "Triangles: " << mesh.mapped_triangles << std::endl;
+            std::cout << "Unique Vertices: " << mesh.mapped_vertices << std::endl;
+            std::cout << "Mapped mesh file: " << mesh.mapped_file << std::endl;
+            continue;
+        }
+        std::cout << "Triangles: " << mesh.buffers.triangle_count() << std::endl;
+        std::cout << "Unique Vertices: " << mesh.buffers.vertex_count() << std::endl;
+        std::cout << "Vertex Normals: " << mesh.buffers.normals.size() / 3 << std::endl;
+        std::cout << "Mesh memory: " << mesh.buffers.memory_bytes() / 1024 << " KB" << std::endl;
+    }
+}
+
+void MarchingCubes::filter_components(size_t min_triangles, size_t level) {
+    if (level >= meshes.size()) {
+        std::cerr << "No mesh generated for level " << level << std::endl;
+        return;
+    }
+
+    ComponentStats stats;
+    remove_small_components(meshes[level].buffers, min_triangles, &stats);
+    meshes[level].optimized = false;
+
+    std::cout << "Connected components: " << stats.component_count << ", kept " << stats.kept_components
+              << " with at least " << min_triangles << " triangles" << std::endl;
+    std::cout << "Removed " << stats.removed_triangles << " triangles and " << stats.removed_vertices << " vertices" << std::endl;
+    std::cout << "Largest components (triangles):";
+    for (size_t i = 0; i < std::min<size_t>(stats.triangle_counts.size(), 5); i++) {
+        std::cout << " " << stats.triangle_counts[i];
+    }
+    std::cout << std::endl;
+}
+
+void MarchingCubes::smooth_mesh(int iterations, size_t level) {
+    if (level >= meshes.size()) {
+        std::cerr << "No mesh generated for level " << level << std::endl;
+        return;
+    }
+
+    MeshBuffers& buffers = meshes[level].buffers;
+    smooth_mesh_taubin(buffers, iterations);
+    meshes[level].optimized = false;
+
+    // Las normales del gradiente siguen describiendo el campo; las de caras se recalculan
+    if (normal_mode == NormalMode::Face) {
+        buffers.compute_vertex_normals();
+    }
+    std::cout << "Mesh smoothed: " << iterations << " Taubin iterations" << std::endl;
+}
+
+void MarchingCubes::decimate_mesh(const SimplificationOptions& options, size_t level) {
+    if (level >= meshes.size()) {
+        std::cerr << "No mesh generated for level " << level << std::endl;
+        return;
+    }
+
+    SimplificationStats stats;
+    meshes[level].buffers = simplify_mesh(meshes[level].buffers, options, &stats);
+    meshes[level].optimized = false;
+    std::cout << "Mesh decimated: " << stats.input_triangles << " -> " << stats.output_triangles
+              << " triangles (max error " << stats.max_error << ")" << std::endl;
+}
+
+void MarchingCubes::optimize_mesh(size_t level) {
+    if (level >= meshes.size()) {
+        std::cerr << "No mesh generated for level " << level << std::endl;
+        return;
+    }
+
+    MeshBuffers& buffers = meshes[level].buffers;
+    double acmr_before = average_cache_miss_ratio(buffers.indices, buffers.vertex_count());
+    ::optimize_mesh(buffers);
+    meshes[level].optimized = true;
+    std::cout << "Mesh optimized: ACMR " << acmr_before << " -> "
+              << average_cache_miss_ratio(buffers.indices, buffers.vertex_count()) << std::endl;
+}
+
+void MarchingCubes::export_file_obj(const std::string& fileobj, size_t level) {
+    if (level >= meshes.size()) {
+        std::cerr << "No mesh generated for level " << level << std::endl;
+        return;
+    }
+
+    if (write_mesh_obj(fileobj, meshes[level].buffers)) {
+        std::cout << "Mesh exported to " << fileobj << std::endl;
+    }
+}
+
+void MarchingCubes::export_file_ply(const std::string& fileply, size_t level) {
+    if (level >= meshes.size()) {
+        std::cerr << "No mesh generated for level " << level << std::endl;
+        return;
+    }
+
+    if (write_mesh_ply(fileply, meshes[level].buffers)) {
+        std::cout << "Mesh exported to " << fileply << std::endl;
+    }
+}
+
+void MarchingCubes::export_file_native(const std::string& filemesh, bool with_meshlets, size_t level) {
+    if (level >= meshes.size()) {
+        std::cerr << "No mesh generated for level " << level << std::endl;
+        return;
+    }
+
+    MeshletData meshlets;
+    if (with_meshlets) {
+        meshlets = build_meshlets(meshes[level].buffers);
+        std::cout << "Meshlets: " << meshlets.meshlets.size() << " (" << meshlets.vertices.size() << " vertex references)" << std::endl;
+    }
+
+    if (write_mesh_native(filemesh, meshes[level].buffers, with_meshlets ? &meshlets : nullptr)) {
+        std::cout << "Mesh exported to " << filemesh << std::endl;
+    }
+}
+
+void MarchingCubes::export_file_compressed(const std::string& filemesh, int normal_bits, size_t level) {
+    if (level >= meshes.size()) {
+        std::cerr << "No mesh generated for level " << level << std::endl;
+        return;
+    }
+
+    if (write_mesh_compressed(filemesh, meshes[level].buffers, normal_bits)) {
+        std::cout << "Mesh exported to " << filemesh << std::endl;
+    }
+}
+
+void MarchingCubes::export_file_lod(const std::string& filelod, const std::vector<float>& ratios, size_t level) {
+    if (level >= meshes.size()) {
+        std::cerr << "No mesh generated for level " << level << std::endl;
+        return;
+    }
+
+    std::vector<LodLevel> lod_levels = build_lod_chain(meshes[level].buffers, ratios);
+    if (meshes[level].optimized) {
+        // Los niveles simplificados pierden el orden optimizado de la malla original
+        for (size_t i = 1; i < lod_levels.size(); i++) {
+            ::optimize_mesh(lod_levels[i].mesh);
+        }
+    }
+    for (const auto& lod : lod_levels) {
+        std::cout << "LOD " << lod.triangle_ratio * 100.0f << "%: " << lod.mesh.triangle_count()
+                  << " triangles, error " << lod.geometric_error << std::endl;
+    }
+
+    if (write_mesh_lod(filelod, lod_levels)) {
+        std::cout << "Mesh exported to " << filelod << std::endl;
+    }
+}
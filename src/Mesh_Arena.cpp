@@ -0,0 +1,126 @@
+#include "../headers/Mesh_Arena.h"
+
+void VertexLookup::reserve(size_t expected) {
+    size_t capacity = 1024;
+    while (capacity < expected * 2) {
+        capacity <<= 1;
+    }
+    if (capacity <= keys.size()) {
+        return;
+    }
+
+    std::vector<uint64_t> old_keys = std::move(keys);
+    std::vector<uint32_t> old_values = std::move(values);
+    keys.assign(capacity, empty_key);
+    values.assign(capacity, 0);
+    mask = capacity - 1;
+    count = 0;
+
+    for (size_t i = 0; i < old_keys.size(); i++) {
+        if (old_keys[i] != empty_key) {
+            uint32_t unused;
+            find_or_insert(old_keys[i], old_values[i], unused);
+        }
+    }
+}
+
+void VertexLookup::grow() {
+    reserve(keys.empty() ? 1024 : keys.size());
+}
+
+bool VertexLookup::find_or_insert(uint64_t key, uint32_t value, uint32_t& found) {
+    if ((count + 1) * 2 > keys.size()) {
+        grow();
+    }
+
+    size_t slot = slot_for(key);
+    while (keys[slot] != empty_key) {
+        if (keys[slot] == key) {
+            found = values[slot];
+            return true;
+        }
+        slot = (slot + 1) & mask;
+    }
+
+    keys[slot] = key;
+    values[slot] = value;
+    count++;
+    found = value;
+    return false;
+}
+
+bool VertexLookup::find(uint64_t key, uint32_t& found) const {
+    if (keys.empty()) {
+        return false;
+    }
+
+    size_t slot = slot_for(key);
+    while (keys[slot] != empty_key) {
+        if (keys[slot] == key) {
+            found = values[slot];
+            return true;
+        }
+        slot = (slot + 1) & mask;
+    }
+    return false;
+}
+
+void VertexLookup::keys_by_value(std::vector<uint64_t>& result) const {
+    result.assign(count, empty_key);
+    for (size_t i = 0; i < keys.size(); i++) {
+        if (keys[i] == empty_key) {
+            continue;
+        }
+        if (values[i] >= result.size()) {
+            result.resize((size_t)values[i] + 1, empty_key);
+        }
+        result[values[i]] = keys[i];
+    }
+}
+
+void VertexLookup::clear() {
+    keys.clear();
+    keys.shrink_to_fit();
+    values.clear();
+    values.shrink_to_fit();
+    mask = 0;
+    count = 0;
+}
+
+void MeshArena::reserve(size_t expected_vertices, size_t expected_triangles) {
+    positions.set_items_per_block(expected_vertices / 4);
+    normals.set_items_per_block(expected_vertices / 4);
+    triangles.set_items_per_block(expected_triangles / 4);
+    lookup.reserve(expected_vertices);
+}
+
+uint32_t MeshArena::add_vertex(const float position[3], const float normal[3]) {
+    uint32_t index = (uint32_t)positions.size();
+    std::memcpy(positions.allocate(), position, 3 * sizeof(float));
+    std::memcpy(normals.allocate(), normal, 3 * sizeof(float));
+    return index;
+}
+
+void MeshArena::add_triangle(uint32_t a, uint32_t b, uint32_t c) {
+    uint32_t* triangle = triangles.allocate();
+    triangle[0] = a;
+    triangle[1] = b;
+    triangle[2] = c;
+}
+
+void MeshArena::flatten_into(MeshBuffers& buffers) {
+    buffers.positions.resize(positions.size() * 3);
+    buffers.normals.resize(normals.size() * 3);
+    buffers.indices.resize(triangles.size() * 3);
+
+    positions.copy_to(buffers.positions.data());
+    normals.copy_to(buffers.normals.data());
+    triangles.copy_to(buffers.indices.data());
+}
+
+void MeshArena::clear() {
+    positions.clear();
+    normals.clear();
+    triangles.clear();
+    lookup.clear();
+}
@@ -0,0 +1,134 @@
+#include "../headers/Mesh_Buffers.h"
+
+#include <cmath>
+#include <algorithm>
+#include <utility>
+
+void MeshBuffers::clear() {
+    positions.clear();
+    normals.clear();
+    indices.clear();
+}
+
+void MeshBuffers::reserve(size_t vertices, size_t triangles) {
+    positions.reserve(vertices * 3);
+    normals.reserve(vertices * 3);
+    indices.reserve(triangles * 3);
+}
+
+uint32_t MeshBuffers::add_vertex(float x, float y, float z, float normal_x, float normal_y, float normal_z) {
+    uint32_t index = (uint32_t)vertex_count();
+    positions.insert(positions.end(), { x, y, z });
+    normals.insert(normals.end(), { normal_x, normal_y, normal_z });
+    return index;
+}
+
+void MeshBuffers::add_triangle(uint32_t a, uint32_t b, uint32_t c) {
+    indices.insert(indices.end(), { a, b, c });
+}
+
+void MeshBuffers::compute_bounds(float min_bounds[3], float max_bounds[3]) const {
+    ::compute_bounds(positions.data(), vertex_count(), min_bounds, max_bounds);
+}
+
+std::vector<float> MeshBuffers::compute_face_normals() const {
+    std::vector<float> face_normals(indices.size(), 0.0f);
+
+    for (size_t t = 0; t < triangle_count(); t++) {
+        const float* v0 = &positions[(size_t)indices[t * 3] * 3];
+        const float* v1 = &positions[(size_t)indices[t * 3 + 1] * 3];
+        const float* v2 = &positions[(size_t)indices[t * 3 + 2] * 3];
+
+        float e1x = v1[0] - v0[0], e1y = v1[1] - v0[1], e1z = v1[2] - v0[2];
+        float e2x = v2[0] - v0[0], e2y = v2[1] - v0[1], e2z = v2[2] - v0[2];
+
+        float nx = e1y * e2z - e1z * e2y;
+        float ny = e1z * e2x - e1x * e2z;
+        float nz = e1x * e2y - e1y * e2x;
+        float length = std::sqrt(nx * nx + ny * ny + nz * nz);
+        if (length > 0) {
+            face_normals[t * 3] = nx / length;
+            face_normals[t * 3 + 1] = ny / length;
+            face_normals[t * 3 + 2] = nz / length;
+        }
+    }
+
+    return face_normals;
+}
+
+void MeshBuffers::compute_vertex_normals() {
+    normals.resize(positions.size());
+    ::compute_vertex_normals(positions.data(), vertex_count(), indices.data(), indices.size(), normals.data());
+}
+
+size_t MeshBuffers::memory_bytes() const {
+    return positions.capacity() * sizeof(float) + normals.capacity() * sizeof(float) + indices.capacity() * sizeof(uint32_t);
+}
+
+std::vector<float> MeshBuffers::take_positions() {
+    return std::move(positions);
+}
+
+std::vector<float> MeshBuffers::take_normals() {
+    return std::move(normals);
+}
+
+std::vector<uint32_t> MeshBuffers::take_indices() {
+    return std::move(indices);
+}
+
+void compute_bounds(const float* positions, size_t vertex_count, float min_bounds[3], float max_bounds[3]) {
+    for (int axis = 0; axis < 3; axis++) {
+        min_bounds[axis] = vertex_count == 0 ? 0.0f : positions[axis];
+        max_bounds[axis] = min_bounds[axis];
+    }
+
+    for (size_t i = 0; i < vertex_count * 3; i += 3) {
+        for (int axis = 0; axis < 3; axis++) {
+            min_bounds[axis] = std::min(min_bounds[axis], positions[i + axis]);
+            max_bounds[axis] = std::max(max_bounds[axis], positions[i + axis]);
+        }
+    }
+}
+
+// Suma en cada vértice las normales unitarias de sus caras y normaliza; no necesita memoria auxiliar
+void compute_vertex_normals(const float* positions, size_t vertex_count, const uint32_t* indices, size_t index_count, float* normals) {
+    std::fill(normals, normals + vertex_count * 3, 0.0f);
+
+    for (size_t t = 0; t + 2 < index_count; t += 3) {
+        const float* v0 = &positions[(size_t)indices[t] * 3];
+        const float* v1 = &positions[(size_t)indices[t + 1] * 3];
+        const float* v2 = &positions[(size_t)indices[t + 2] * 3];
+
+        float e1x = v1[0] - v0[0], e1y = v1[1] - v0[1], e1z = v1[2] - v0[2];
+        float e2x = v2[0] - v0[0], e2y = v2[1] - v0[1], e2z = v2[2] - v0[2];
+
+        float face_normal[3] = { 0.0f, 0.0f, 0.0f };
+        float nx = e1y * e2z - e1z * e2y;
+        float ny = e1z * e2x - e1x * e2z;
+        float nz = e1x * e2y - e1y * e2x;
+        float length = std::sqrt(nx * nx + ny * ny + nz * nz);
+        if (length > 0) {
+            face_normal[0] = nx / length;
+            face_normal[1] = ny / length;
+            face_normal[2] = nz / length;
+        }
+
+        for (int k = 0; k < 3; k++) {
+            float* normal = &normals[(size_t)indices[t + k] * 3];
+            normal[0] += face_normal[0];
+            normal[1] += face_normal[1];
+            normal[2] += face_normal[2];
+        }
+    }
+
+    for (size_t v = 0; v < vertex_count; v++) {
+        float* normal = &normals[v * 3];
+        float length = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+        if (length > 0) {
+            normal[0] /= length;
+            normal[1] /= length;
+            normal[2] /= length;
+        }
+    }
+}
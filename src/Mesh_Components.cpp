@@ -0,0 +1,141 @@
+#include "../headers/Mesh_Components.h"
+#include "../headers/Parallel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+namespace {
+
+// Union-find concurrente: enlaces con compare_exchange y compresión por división a la mitad
+class ConcurrentUnionFind {
+    private:
+        std::unique_ptr<std::atomic<uint32_t>[]> parent;
+
+    public:
+        explicit ConcurrentUnionFind(size_t count) : parent(new std::atomic<uint32_t>[count]) {
+            parallel_for(0, count, [&](size_t begin, size_t end, size_t) {
+                for (size_t i = begin; i < end; i++) {
+                    parent[i].store((uint32_t)i, std::memory_order_relaxed);
+                }
+            });
+        }
+
+        uint32_t find(uint32_t x) {
+            while (true) {
+                uint32_t p = parent[x].load(std::memory_order_relaxed);
+                if (p == x) {
+                    return x;
+                }
+                uint32_t grandparent = parent[p].load(std::memory_order_relaxed);
+                if (p != grandparent) {
+                    parent[x].compare_exchange_weak(p, grandparent, std::memory_order_relaxed);
+                }
+                x = grandparent;
+            }
+        }
+
+        void unite(uint32_t a, uint32_t b) {
+            while (true) {
+                a = find(a);
+                b = find(b);
+                if (a == b) {
+                    return;
+                }
+                // La raíz mayor se cuelga de la menor para que no se formen ciclos
+                if (a < b) {
+                    std::swap(a, b);
+                }
+                uint32_t expected = a;
+                if (parent[a].compare_exchange_strong(expected, b, std::memory_order_relaxed)) {
+                    return;
+                }
+            }
+        }
+};
+
+}
+
+void remove_small_components(MeshBuffers& mesh, size_t min_triangles, ComponentStats* stats) {
+    size_t vertex_count = mesh.vertex_count();
+    size_t triangle_count = mesh.triangle_count();
+    if (triangle_count == 0) {
+        return;
+    }
+
+    ConcurrentUnionFind components(vertex_count);
+    parallel_for(0, triangle_count, [&](size_t begin, size_t end, size_t) {
+        for (size_t t = begin; t < end; t++) {
+            const uint32_t* tri = &mesh.indices[t * 3];
+            components.unite(tri[0], tri[1]);
+            components.unite(tri[0], tri[2]);
+        }
+    });
+
+    std::vector<uint32_t> root(vertex_count);
+    parallel_for(0, vertex_count, [&](size_t begin, size_t end, size_t) {
+        for (size_t v = begin; v < end; v++) {
+            root[v] = components.find((uint32_t)v);
+        }
+    });
+
+    std::vector<size_t> component_triangles(vertex_count, 0);
+    for (size_t t = 0; t < triangle_count; t++) {
+        component_triangles[root[mesh.indices[t * 3]]]++;
+    }
+
+    ComponentStats local_stats;
+    for (size_t v = 0; v < vertex_count; v++) {
+        if (root[v] == v && component_triangles[v] > 0) {
+            local_stats.triangle_counts.push_back(component_triangles[v]);
+            if (component_triangles[v] >= min_triangles) {
+                local_stats.kept_components++;
+            }
+        }
+    }
+    local_stats.component_count = local_stats.triangle_counts.size();
+    std::sort(local_stats.triangle_counts.begin(), local_stats.triangle_counts.end(), std::greater<size_t>());
+
+    if (local_stats.kept_components < local_stats.component_count) {
+        // Se conservan los vértices y triángulos de las componentes grandes en su orden original
+        std::vector<uint32_t> remap(vertex_count, UINT32_MAX);
+        size_t kept_vertices = 0;
+        bool has_normals = mesh.normals.size() == mesh.positions.size();
+        for (size_t v = 0; v < vertex_count; v++) {
+            if (component_triangles[root[v]] >= min_triangles) {
+                remap[v] = (uint32_t)kept_vertices;
+                for (int k = 0; k < 3; k++) {
+                    mesh.positions[kept_vertices * 3 + k] = mesh.positions[v * 3 + k];
+                    if (has_normals) {
+                        mesh.normals[kept_vertices * 3 + k] = mesh.normals[v * 3 + k];
+                    }
+                }
+                kept_vertices++;
+            }
+        }
+
+        size_t kept_indices = 0;
+        for (size_t t = 0; t < triangle_count; t++) {
+            if (remap[mesh.indices[t * 3]] == UINT32_MAX) {
+                continue;
+            }
+            for (int k = 0; k < 3; k++) {
+                mesh.indices[kept_indices++] = remap[mesh.indices[t * 3 + k]];
+            }
+        }
+
+        local_stats.removed_vertices = vertex_count - kept_vertices;
+        local_stats.removed_triangles = triangle_count - kept_indices / 3;
+        mesh.positions.resize(kept_vertices * 3);
+        if (has_normals) {
+            mesh.normals.resize(kept_vertices * 3);
+        }
+        mesh.indices.resize(kept_indices);
+    }
+
+    if (stats != nullptr) {
+        *stats = std::move(local_stats);
+    }
+}
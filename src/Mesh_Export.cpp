@@ -0,0 +1,767 @@
+#include "../headers/Mesh_Export.h"
+#include "../headers/Parallel.h"
+#include "../headers/Mesh_Arena.h"
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <cstring>
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+
+static size_t align_offset(size_t offset) {
+    return (offset + native_mesh_alignment - 1) / native_mesh_alignment * native_mesh_alignment;
+}
+
+static void write_aligned_block(std::ofstream& file, uint64_t offset, const void* data, size_t bytes) {
+    static const char padding[native_mesh_alignment] = {};
+    size_t position = (size_t)file.tellp();
+    file.write(padding, (std::streamsize)(offset - position));
+    file.write(static_cast<const char*>(data), (std::streamsize)bytes);
+}
+
+// Cabecera de un .rmesh sin meshlets con los bloques alineados uno detrás de otro
+static NativeMeshHeader native_mesh_layout(size_t vertex_count, size_t index_count) {
+    NativeMeshHeader header = {};
+    std::memcpy(header.magic, "RC3DMSH\0", 8);
+    header.version = native_mesh_version;
+    header.header_size = sizeof(NativeMeshHeader);
+    header.vertex_count = vertex_count;
+    header.index_count = index_count;
+
+    size_t vertex_bytes = vertex_count * 3 * sizeof(float);
+    header.positions_offset = align_offset(sizeof(NativeMeshHeader));
+    header.normals_offset = align_offset(header.positions_offset + vertex_bytes);
+    header.indices_offset = align_offset(header.normals_offset + vertex_bytes);
+    header.file_size = header.indices_offset + index_count * sizeof(uint32_t);
+    return header;
+}
+
+static char* append_float(char* out, float value) {
+    // Representación más corta que se relee sin pérdida
+    return std::to_chars(out, out + 32, value).ptr;
+}
+
+static char* append_uint(char* out, uint32_t value) {
+    return std::to_chars(out, out + 16, value).ptr;
+}
+
+// Formatea [0, count) elementos en bloques; varios bloques se formatean en paralelo y se escriben en orden
+template <typename FormatItem>
+static void write_text_section(std::ofstream& file, size_t count, size_t max_item_chars, FormatItem format_item) {
+    const size_t items_per_chunk = 1 << 15;
+    size_t chunk_count = (count + items_per_chunk - 1) / items_per_chunk;
+    size_t chunks_per_batch = worker_count() * 2;
+    std::vector<std::vector<char>> buffers(chunks_per_batch);
+
+    for (size_t first_chunk = 0; first_chunk < chunk_count; first_chunk += chunks_per_batch) {
+        size_t batch_chunks = std::min(chunks_per_batch, chunk_count - first_chunk);
+
+        parallel_for(0, batch_chunks, [&](size_t begin, size_t end, size_t) {
+            for (size_t c = begin; c < end; c++) {
+                size_t item_begin = (first_chunk + c) * items_per_chunk;
+                size_t item_end = std::min(count, item_begin + items_per_chunk);
+                std::vector<char>& buffer = buffers[c];
+                buffer.resize((item_end - item_begin) * max_item_chars);
+
+                char* out = buffer.data();
+                for (size_t i = item_begin; i < item_end; i++) {
+                    out = format_item(out, i);
+                }
+                buffer.resize(out - buffer.data());
+            }
+        }, 1);
+
+        for (size_t c = 0; c < batch_chunks; c++) {
+            file.write(buffers[c].data(), (std::streamsize)buffers[c].size());
+        }
+    }
+}
+
+bool write_mesh_obj(const std::string& filename, const MeshBuffers& mesh) {
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Error opening file for writing: " << filename << std::endl;
+        return false;
+    }
+
+    auto write_vector = [](char* out, const char* prefix, size_t length, const float* values) {
+        std::memcpy(out, prefix, length);
+        out += length;
+        for (int axis = 0; axis < 3; axis++) {
+            out = append_float(out, values[axis]);
+            *out++ = axis < 2 ? ' ' : '\n';
+        }
+        return out;
+    };
+
+    write_text_section(file, mesh.vertex_count(), 3 + 3 * 16, [&](char* out, size_t v) {
+        return write_vector(out, "v ", 2, &mesh.positions[v * 3]);
+    });
+
+    write_text_section(file, mesh.vertex_count(), 3 + 3 * 16, [&](char* out, size_t v) {
+        return write_vector(out, "vn ", 3, &mesh.normals[v * 3]);
+    });
+
+    write_text_section(file, mesh.triangle_count(), 2 + 3 * 24, [&](char* out, size_t t) {
+        *out++ = 'f';
+        for (int i = 0; i < 3; i++) {
+            uint32_t index = mesh.indices[t * 3 + i] + 1;
+            *out++ = ' ';
+            out = append_uint(out, index);
+            *out++ = '/';
+            *out++ = '/';
+            out = append_uint(out, index);
+        }
+        *out++ = '\n';
+        return out;
+    });
+
+    return file.good();
+}
+
+bool write_mesh_ply(const std::string& filename, const MeshBuffers& mesh) {
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Error opening file for writing: " << filename << std::endl;
+        return false;
+    }
+
+    file << "ply\n"
+         << "format binary_little_endian 1.0\n"
+         << "element vertex " << mesh.vertex_count() << "\n"
+         << "property float x\n"
+         << "property float y\n"
+         << "property float z\n"
+         << "property float nx\n"
+         << "property float ny\n"
+         << "property float nz\n"
+         << "element face " << mesh.triangle_count() << "\n"
+         << "property list uchar uint vertex_indices\n"
+         << "end_header\n";
+
+    // Los bloques se arman en un buffer intermedio para escribir con pocas llamadas
+    const size_t batch = 1 << 16;
+    std::vector<char> buffer;
+    buffer.reserve(batch * 24);
+
+    for (size_t begin = 0; begin < mesh.vertex_count(); begin += batch) {
+        size_t end = std::min(begin + batch, mesh.vertex_count());
+        buffer.resize((end - begin) * 24);
+        char* out = buffer.data();
+        for (size_t v = begin; v < end; v++) {
+            std::memcpy(out, &mesh.positions[v * 3], 12);
+            std::memcpy(out + 12, &mesh.normals[v * 3], 12);
+            out += 24;
+        }
+        file.write(buffer.data(), (std::streamsize)buffer.size());
+    }
+
+    for (size_t begin = 0; begin < mesh.triangle_count(); begin += batch) {
+        size_t end = std::min(begin + batch, mesh.triangle_count());
+        buffer.resize((end - begin) * 13);
+        char* out = buffer.data();
+        for (size_t t = begin; t < end; t++) {
+            *out = 3;
+            std::memcpy(out + 1, &mesh.indices[t * 3], 12);
+            out += 13;
+        }
+        file.write(buffer.data(), (std::streamsize)buffer.size());
+    }
+
+    return file.good();
+}
+
+bool write_mesh_native(const std::string& filename, const MeshBuffers& mesh, const MeshletData* meshlets) {
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Error opening file for writing: " << filename << std::endl;
+        return false;
+    }
+
+    NativeMeshHeader header = native_mesh_layout(mesh.vertex_count(), mesh.indices.size());
+    mesh.compute_bounds(header.min_bounds, header.max_bounds);
+    size_t vertex_bytes = mesh.vertex_count() * 3 * sizeof(float);
+
+    if (meshlets != nullptr && !meshlets->empty()) {
+        header.meshlet_count = meshlets->meshlets.size();
+        header.meshlet_vertex_count = meshlets->vertices.size();
+        header.meshlet_triangle_count = meshlets->triangles.size() / 3;
+        header.meshlets_offset = align_offset(header.file_size);
+        header.meshlet_vertices_offset = align_offset(header.meshlets_offset + meshlets->meshlets.size() * sizeof(Meshlet));
+        header.meshlet_triangles_offset = align_offset(header.meshlet_vertices_offset + meshlets->vertices.size() * sizeof(uint32_t));
+        header.file_size = header.meshlet_triangles_offset + meshlets->triangles.size();
+    }
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    write_aligned_block(file, header.positions_offset, mesh.positions.data(), vertex_bytes);
+    write_aligned_block(file, header.normals_offset, mesh.normals.data(), vertex_bytes);
+    write_aligned_block(file, header.indices_offset, mesh.indices.data(), mesh.indices.size() * sizeof(uint32_t));
+    if (header.meshlet_count > 0) {
+        write_aligned_block(file, header.meshlets_offset, meshlets->meshlets.data(), meshlets->meshlets.size() * sizeof(Meshlet));
+        write_aligned_block(file, header.meshlet_vertices_offset, meshlets->vertices.data(), meshlets->vertices.size() * sizeof(uint32_t));
+        write_aligned_block(file, header.meshlet_triangles_offset, meshlets->triangles.data(), meshlets->triangles.size());
+    }
+
+    return file.good();
+}
+
+bool create_mapped_native_mesh(const std::string& filename, size_t vertex_count, size_t index_count, MappedFile& file) {
+    NativeMeshHeader header = native_mesh_layout(vertex_count, index_count);
+    if (!file.open_write(filename, (size_t)header.file_size)) {
+        std::cerr << "Error mapping file for writing: " << filename << std::endl;
+        return false;
+    }
+    std::memcpy(file.mutable_data(), &header, sizeof(header));
+    file.advise(MappedAccess::Sequential);
+    return true;
+}
+
+bool finish_mapped_native_mesh(MappedFile& file) {
+    NativeMeshHeader header;
+    std::memcpy(&header, file.data(), sizeof(header));
+    compute_bounds(reinterpret_cast<const float*>(file.data() + header.positions_offset), (size_t)header.vertex_count,
+                   header.min_bounds, header.max_bounds);
+    std::memcpy(file.mutable_data(), &header, sizeof(header));
+    bool flushed = file.flush();
+    file.close();
+    return flushed;
+}
+
+bool NativeMeshView::open(const std::string& filename) {
+    if (!file.open_read(filename) || file.size() < 16) {
+        return false;
+    }
+
+    // Los archivos de la versión 1 tienen una cabecera más corta y no traen meshlets
+    header = {};
+    std::memcpy(&header, file.data(), 16);
+    size_t header_bytes = std::min<size_t>(header.header_size, sizeof(NativeMeshHeader));
+    if (std::memcmp(header.magic, "RC3DMSH\0", 8) != 0 ||
+        header.version < 1 || header.version > native_mesh_version ||
+        header_bytes > file.size()) {
+        std::cerr << "Invalid native mesh file: " << filename << std::endl;
+        file.close();
+        return false;
+    }
+
+    std::memcpy(&header, file.data(), header_bytes);
+    if (header.file_size > file.size()) {
+        std::cerr << "Invalid native mesh file: " << filename << std::endl;
+        file.close();
+        return false;
+    }
+    return true;
+}
+
+bool write_mesh_lod(const std::string& filename, const std::vector<LodLevel>& levels) {
+    if (levels.empty()) {
+        return false;
+    }
+
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Error opening file for writing: " << filename << std::endl;
+        return false;
+    }
+
+    LodFileHeader header = {};
+    std::memcpy(header.magic, "RC3DLOD\0", 8);
+    header.version = lod_file_version;
+    header.level_count = (uint32_t)levels.size();
+    levels[0].mesh.compute_bounds(header.min_bounds, header.max_bounds);
+    header.levels_offset = align_offset(sizeof(LodFileHeader));
+
+    std::vector<LodLevelEntry> entries(levels.size());
+    size_t offset = header.levels_offset + levels.size() * sizeof(LodLevelEntry);
+    for (size_t i = 0; i < levels.size(); i++) {
+        const MeshBuffers& mesh = levels[i].mesh;
+        size_t vertex_bytes = mesh.vertex_count() * 3 * sizeof(float);
+        entries[i].vertex_count = mesh.vertex_count();
+        entries[i].index_count = mesh.indices.size();
+        entries[i].triangle_ratio = levels[i].triangle_ratio;
+        entries[i].geometric_error = levels[i].geometric_error;
+        entries[i].positions_offset = align_offset(offset);
+        entries[i].normals_offset = align_offset(entries[i].positions_offset + vertex_bytes);
+        entries[i].indices_offset = align_offset(entries[i].normals_offset + vertex_bytes);
+        offset = entries[i].indices_offset + mesh.indices.size() * sizeof(uint32_t);
+    }
+    header.file_size = offset;
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    write_aligned_block(file, header.levels_offset, entries.data(), entries.size() * sizeof(LodLevelEntry));
+    for (size_t i = 0; i < levels.size(); i++) {
+        const MeshBuffers& mesh = levels[i].mesh;
+        size_t vertex_bytes = mesh.vertex_count() * 3 * sizeof(float);
+        write_aligned_block(file, entries[i].positions_offset, mesh.positions.data(), vertex_bytes);
+        write_aligned_block(file, entries[i].normals_offset, mesh.normals.data(), vertex_bytes);
+        write_aligned_block(file, entries[i].indices_offset, mesh.indices.data(), mesh.indices.size() * sizeof(uint32_t));
+    }
+
+    return file.good();
+}
+
+bool LodMeshView::open(const std::string& filename) {
+    if (!file.open_read(filename) || file.size() < sizeof(LodFileHeader)) {
+        return false;
+    }
+
+    std::memcpy(&header, file.data(), sizeof(LodFileHeader));
+    if (std::memcmp(header.magic, "RC3DLOD\0", 8) != 0 ||
+        header.version != lod_file_version ||
+        header.level_count == 0 ||
+        header.file_size > file.size() ||
+        header.levels_offset + header.level_count * sizeof(LodLevelEntry) > file.size()) {
+        std::cerr << "Invalid LOD mesh file: " << filename << std::endl;
+        file.close();
+        return false;
+    }
+
+    entries = reinterpret_cast<const LodLevelEntry*>(file.data() + header.levels_offset);
+    return true;
+}
+
+size_t LodMeshView::select_level(float pixels_per_unit, float max_pixel_error) const {
+    size_t selected = 0;
+    for (size_t i = 0; i < level_count(); i++) {
+        if (entries[i].geometric_error * pixels_per_unit <= max_pixel_error) {
+            selected = i;
+        }
+    }
+    return selected;
+}
+
+static void append_varint(std::vector<uint8_t>& out, uint32_t value) {
+    while (value >= 0x80) {
+        out.push_back((uint8_t)(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back((uint8_t)value);
+}
+
+static bool read_varint(const uint8_t*& data, const uint8_t* end, uint32_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 35 && data < end; shift += 7) {
+        uint8_t byte = *data++;
+        value |= (uint32_t)(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static uint32_t zigzag_encode(int32_t value) {
+    return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+static int32_t zigzag_decode(uint32_t value) {
+    return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+}
+
+static void octahedral_encode(const float* normal, int bits, uint32_t& u, uint32_t& v) {
+    float x = normal[0];
+    float y = normal[1];
+    float z = normal[2];
+    float length = std::fabs(x) + std::fabs(y) + std::fabs(z);
+    if (length <= 0.0f) {
+        x = 0.0f; y = 0.0f; z = 1.0f; length = 1.0f;
+    }
+    x /= length;
+    y /= length;
+    if (z < 0.0f) {
+        float folded_x = (1.0f - std::fabs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+        float folded_y = (1.0f - std::fabs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+        x = folded_x;
+        y = folded_y;
+    }
+    float scale = (float)((1u << bits) - 1);
+    u = (uint32_t)std::lround((x * 0.5f + 0.5f) * scale);
+    v = (uint32_t)std::lround((y * 0.5f + 0.5f) * scale);
+}
+
+static void octahedral_decode(uint32_t u, uint32_t v, int bits, float* normal) {
+    float scale = (float)((1u << bits) - 1);
+    float x = (float)u / scale * 2.0f - 1.0f;
+    float y = (float)v / scale * 2.0f - 1.0f;
+    float z = 1.0f - std::fabs(x) - std::fabs(y);
+    if (z < 0.0f) {
+        float folded_x = (1.0f - std::fabs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+        float folded_y = (1.0f - std::fabs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+        x = folded_x;
+        y = folded_y;
+    }
+    float length = std::sqrt(x * x + y * y + z * z);
+    normal[0] = x / length;
+    normal[1] = y / length;
+    normal[2] = z / length;
+}
+
+// Bloque de vértices: normales de tamaño fijo y luego posiciones cuantizadas como diferencias con el vértice anterior
+static void encode_vertex_block(const MeshBuffers& mesh, size_t first, size_t count, const float* min_bounds,
+                                const float* extent, int normal_bits, std::vector<uint8_t>& out) {
+    bool has_normals = mesh.normals.size() == mesh.positions.size();
+    size_t normal_bytes = normal_bits / 8;
+    out.reserve(count * (2 * normal_bytes + 6));
+
+    for (size_t i = first; i < first + count; i++) {
+        const float zero[3] = { 0.0f, 0.0f, 1.0f };
+        uint32_t u, v;
+        octahedral_encode(has_normals ? &mesh.normals[i * 3] : zero, normal_bits, u, v);
+        for (uint32_t value : { u, v }) {
+            for (size_t b = 0; b < normal_bytes; b++) {
+                out.push_back((uint8_t)(value >> (8 * b)));
+            }
+        }
+    }
+
+    int32_t previous[3] = { 0, 0, 0 };
+    for (size_t i = first; i < first + count; i++) {
+        for (int k = 0; k < 3; k++) {
+            float normalized = extent[k] > 0.0f ? (mesh.positions[i * 3 + k] - min_bounds[k]) / extent[k] : 0.0f;
+            int32_t quantized = (int32_t)std::lround(std::min(std::max(normalized, 0.0f), 1.0f) * 65535.0f);
+            append_varint(out, zigzag_encode(quantized - previous[k]));
+            previous[k] = quantized;
+        }
+    }
+}
+
+static bool decode_vertex_block(const uint8_t* data, const uint8_t* end, size_t first, size_t count,
+                                const CompressedMeshHeader& header, MeshBuffers& mesh) {
+    int normal_bits = (int)header.normal_bits;
+    size_t normal_bytes = normal_bits / 8;
+    if ((size_t)(end - data) < count * 2 * normal_bytes) {
+        return false;
+    }
+
+    for (size_t i = first; i < first + count; i++) {
+        uint32_t values[2] = { 0, 0 };
+        for (int c = 0; c < 2; c++) {
+            for (size_t b = 0; b < normal_bytes; b++) {
+                values[c] |= (uint32_t)(*data++) << (8 * b);
+            }
+        }
+        octahedral_decode(values[0], values[1], normal_bits, &mesh.normals[i * 3]);
+    }
+
+    int32_t previous[3] = { 0, 0, 0 };
+    for (size_t i = first; i < first + count; i++) {
+        for (int k = 0; k < 3; k++) {
+            uint32_t delta;
+            if (!read_varint(data, end, delta)) {
+                return false;
+            }
+            previous[k] += zigzag_decode(delta);
+            float extent = header.max_bounds[k] - header.min_bounds[k];
+            mesh.positions[i * 3 + k] = header.min_bounds[k] + (float)previous[k] / 65535.0f * extent;
+        }
+    }
+    return true;
+}
+
+static void encode_index_block(const MeshBuffers& mesh, size_t first, size_t count, std::vector<uint8_t>& out) {
+    out.reserve(count * 2);
+    int32_t previous = 0;
+    for (size_t i = first; i < first + count; i++) {
+        int32_t index = (int32_t)mesh.indices[i];
+        append_varint(out, zigzag_encode(index - previous));
+        previous = index;
+    }
+}
+
+static bool decode_index_block(const uint8_t* data, const uint8_t* end, size_t first, size_t count,
+                               size_t vertex_count, MeshBuffers& mesh) {
+    int32_t previous = 0;
+    for (size_t i = first; i < first + count; i++) {
+        uint32_t delta;
+        if (!read_varint(data, end, delta)) {
+            return false;
+        }
+        previous += zigzag_decode(delta);
+        if (previous < 0 || (size_t)previous >= vertex_count) {
+            return false;
+        }
+        mesh.indices[i] = (uint32_t)previous;
+    }
+    return true;
+}
+
+bool write_mesh_compressed(const std::string& filename, const MeshBuffers& mesh, int normal_bits) {
+    if (normal_bits != 8 && normal_bits != 16) {
+        std::cerr << "Invalid normal bits for compressed mesh: " << normal_bits << std::endl;
+        return false;
+    }
+
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Error opening file for writing: " << filename << std::endl;
+        return false;
+    }
+
+    CompressedMeshHeader header = {};
+    std::memcpy(header.magic, "RC3DCMP\0", 8);
+    header.version = compressed_mesh_version;
+    header.header_size = sizeof(CompressedMeshHeader);
+    header.vertex_count = mesh.vertex_count();
+    header.index_count = mesh.indices.size();
+    mesh.compute_bounds(header.min_bounds, header.max_bounds);
+    header.normal_bits = (uint32_t)normal_bits;
+    header.vertex_block_count = (uint32_t)((mesh.vertex_count() + compressed_block_vertices - 1) / compressed_block_vertices);
+    header.index_block_count = (uint32_t)((mesh.indices.size() + compressed_block_indices - 1) / compressed_block_indices);
+    header.blocks_offset = sizeof(CompressedMeshHeader);
+
+    float extent[3];
+    for (int k = 0; k < 3; k++) {
+        extent[k] = header.max_bounds[k] - header.min_bounds[k];
+    }
+
+    size_t block_count = header.vertex_block_count + header.index_block_count;
+    std::vector<CompressedBlockEntry> entries(block_count);
+    std::vector<std::vector<uint8_t>> blocks(block_count);
+
+    parallel_for(0, block_count, [&](size_t begin, size_t end, size_t) {
+        for (size_t b = begin; b < end; b++) {
+            if (b < header.vertex_block_count) {
+                size_t first = b * compressed_block_vertices;
+                size_t count = std::min(compressed_block_vertices, mesh.vertex_count() - first);
+                encode_vertex_block(mesh, first, count, header.min_bounds, extent, normal_bits, blocks[b]);
+                entries[b].first = first;
+                entries[b].count = count;
+            } else {
+                size_t first = (b - header.vertex_block_count) * compressed_block_indices;
+                size_t count = std::min(compressed_block_indices, mesh.indices.size() - first);
+                encode_index_block(mesh, first, count, blocks[b]);
+                entries[b].first = first;
+                entries[b].count = count;
+            }
+        }
+    }, 1);
+
+    size_t offset = header.blocks_offset + block_count * sizeof(CompressedBlockEntry);
+    for (size_t b = 0; b < block_count; b++) {
+        entries[b].offset = offset;
+        entries[b].size = blocks[b].size();
+        offset += blocks[b].size();
+    }
+    header.file_size = offset;
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(entries.data()), (std::streamsize)(entries.size() * sizeof(CompressedBlockEntry)));
+    for (const auto& block : blocks) {
+        file.write(reinterpret_cast<const char*>(block.data()), (std::streamsize)block.size());
+    }
+
+    return file.good();
+}
+
+bool read_mesh_compressed(const std::string& filename, MeshBuffers& mesh) {
+    MappedFile file;
+    if (!file.open_read(filename) || file.size() < sizeof(CompressedMeshHeader)) {
+        return false;
+    }
+
+    CompressedMeshHeader header;
+    std::memcpy(&header, file.data(), sizeof(CompressedMeshHeader));
+    size_t block_count = (size_t)header.vertex_block_count + header.index_block_count;
+    if (std::memcmp(header.magic, "RC3DCMP\0", 8) != 0 ||
+        header.version != compressed_mesh_version ||
+        (header.normal_bits != 8 && header.normal_bits != 16) ||
+        header.file_size > file.size() ||
+        header.blocks_offset + block_count * sizeof(CompressedBlockEntry) > file.size()) {
+        std::cerr << "Invalid compressed mesh file: " << filename << std::endl;
+        return false;
+    }
+
+    std::vector<CompressedBlockEntry> entries(block_count);
+    std::memcpy(entries.data(), file.data() + header.blocks_offset, block_count * sizeof(CompressedBlockEntry));
+
+    mesh.positions.resize((size_t)header.vertex_count * 3);
+    mesh.normals.resize((size_t)header.vertex_count * 3);
+    mesh.indices.resize((size_t)header.index_count);
+
+    // Los bloques son independientes y se decodifican en paralelo
+    std::vector<uint8_t> valid(block_count, 0);
+    parallel_for(0, block_count, [&](size_t begin, size_t end, size_t) {
+        for (size_t b = begin; b < end; b++) {
+            const CompressedBlockEntry& entry = entries[b];
+            if (entry.offset + entry.size > file.size()) {
+                continue;
+            }
+            const uint8_t* data = file.data() + entry.offset;
+            const uint8_t* data_end = data + entry.size;
+            if (b < header.vertex_block_count) {
+                valid[b] = entry.first + entry.count <= header.vertex_count &&
+                           decode_vertex_block(data, data_end, (size_t)entry.first, (size_t)entry.count, header, mesh);
+            } else {
+                valid[b] = entry.first + entry.count <= header.index_count &&
+                           decode_index_block(data, data_end, (size_t)entry.first, (size_t)entry.count, (size_t)header.vertex_count, mesh);
+            }
+        }
+    }, 1);
+
+    if (std::find(valid.begin(), valid.end(), 0) != valid.end()) {
+        std::cerr << "Corrupted compressed mesh file: " << filename << std::endl;
+        mesh.clear();
+        return false;
+    }
+    return true;
+}
+
+bool ChunkedMeshWriter::open(const std::string& filename) {
+    file.open(filename, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "Error opening file for writing: " << filename << std::endl;
+        return false;
+    }
+
+    header = {};
+    std::memcpy(header.magic, "RC3DCHK\0", 8);
+    header.version = chunked_mesh_version;
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    return file.good();
+}
+
+bool ChunkedMeshWriter::write_chunk(const MeshBuffers& mesh, const std::vector<uint64_t>& vertex_keys) {
+    if (!file.is_open() || vertex_keys.size() != mesh.vertex_count()) {
+        return false;
+    }
+
+    ChunkRecordHeader record = { mesh.vertex_count(), mesh.indices.size() };
+    file.write(reinterpret_cast<const char*>(&record), sizeof(record));
+    file.write(reinterpret_cast<const char*>(vertex_keys.data()), (std::streamsize)(vertex_keys.size() * sizeof(uint64_t)));
+    file.write(reinterpret_cast<const char*>(mesh.positions.data()), (std::streamsize)(mesh.positions.size() * sizeof(float)));
+    file.write(reinterpret_cast<const char*>(mesh.normals.data()), (std::streamsize)(mesh.normals.size() * sizeof(float)));
+    file.write(reinterpret_cast<const char*>(mesh.indices.data()), (std::streamsize)(mesh.indices.size() * sizeof(uint32_t)));
+
+    header.chunk_count++;
+    header.vertex_count += record.vertex_count;
+    header.index_count += record.index_count;
+    return file.good();
+}
+
+bool ChunkedMeshWriter::close() {
+    if (!file.is_open()) {
+        return false;
+    }
+    file.seekp(0);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    bool good = file.good();
+    file.close();
+    return good;
+}
+
+bool weld_chunked_mesh(const std::vector<std::string>& chunk_files, const std::string& obj_file) {
+    std::ofstream output(obj_file, std::ios::binary);
+    if (!output.is_open()) {
+        std::cerr << "Error opening file for writing: " << obj_file << std::endl;
+        return false;
+    }
+
+    // Solo bloques vecinos comparten vértices: basta con recordar las claves del bloque anterior
+    VertexLookup previous, current;
+    std::vector<uint32_t> remap;
+    std::vector<uint32_t> new_vertices;
+    uint32_t next_vertex = 0;
+    uint64_t welded = 0, triangles = 0, chunks = 0;
+
+    // Los archivos se recorren en orden de Z: el último bloque de uno es vecino del primero del siguiente
+    for (const auto& chunk_file : chunk_files) {
+        MappedFile file;
+        if (!file.open_read(chunk_file) || file.size() < sizeof(ChunkedMeshHeader)) {
+            std::cerr << "Error opening chunked mesh: " << chunk_file << std::endl;
+            return false;
+        }
+
+        ChunkedMeshHeader header;
+        std::memcpy(&header, file.data(), sizeof(header));
+        if (std::memcmp(header.magic, "RC3DCHK\0", 8) != 0 || header.version != chunked_mesh_version) {
+            std::cerr << "Invalid chunked mesh file: " << chunk_file << std::endl;
+            return false;
+        }
+        size_t offset = sizeof(ChunkedMeshHeader);
+
+        for (uint32_t chunk = 0; chunk < header.chunk_count; chunk++) {
+            ChunkRecordHeader record;
+            if (offset + sizeof(record) > file.size()) {
+                std::cerr << "Corrupted chunked mesh file: " << chunk_file << std::endl;
+                return false;
+            }
+            std::memcpy(&record, file.data() + offset, sizeof(record));
+            offset += sizeof(record);
+
+            size_t vertex_count = (size_t)record.vertex_count;
+            size_t index_count = (size_t)record.index_count;
+            size_t record_bytes = vertex_count * (sizeof(uint64_t) + 6 * sizeof(float)) + index_count * sizeof(uint32_t);
+            if (offset + record_bytes > file.size()) {
+                std::cerr << "Corrupted chunked mesh file: " << chunk_file << std::endl;
+                return false;
+            }
+
+            const uint8_t* data = file.data() + offset;
+            std::vector<uint64_t> keys(vertex_count);
+            std::vector<float> positions(vertex_count * 3), normals(vertex_count * 3);
+            std::vector<uint32_t> indices(index_count);
+            std::memcpy(keys.data(), data, vertex_count * sizeof(uint64_t));
+            data += vertex_count * sizeof(uint64_t);
+            std::memcpy(positions.data(), data, vertex_count * 3 * sizeof(float));
+            data += vertex_count * 3 * sizeof(float);
+            std::memcpy(normals.data(), data, vertex_count * 3 * sizeof(float));
+            data += vertex_count * 3 * sizeof(float);
+            std::memcpy(indices.data(), data, index_count * sizeof(uint32_t));
+            offset += record_bytes;
+
+            remap.assign(vertex_count, 0);
+            new_vertices.clear();
+            current.clear();
+            current.reserve(vertex_count);
+            for (size_t v = 0; v < vertex_count; v++) {
+                uint32_t found;
+                if (previous.find(keys[v], found)) {
+                    remap[v] = found;
+                    welded++;
+                } else {
+                    remap[v] = next_vertex++;
+                    new_vertices.push_back((uint32_t)v);
+                }
+                current.find_or_insert(keys[v], remap[v], found);
+            }
+
+            auto write_vector = [](char* out, const char* prefix, size_t length, const float* values) {
+                std::memcpy(out, prefix, length);
+                out += length;
+                for (int axis = 0; axis < 3; axis++) {
+                    out = append_float(out, values[axis]);
+                    *out++ = axis < 2 ? ' ' : '\n';
+                }
+                return out;
+            };
+            write_text_section(output, new_vertices.size(), 3 + 3 * 16, [&](char* out, size_t v) {
+                return write_vector(out, "v ", 2, &positions[new_vertices[v] * 3]);
+            });
+            write_text_section(output, new_vertices.size(), 3 + 3 * 16, [&](char* out, size_t v) {
+                return write_vector(out, "vn ", 3, &normals[new_vertices[v] * 3]);
+            });
+            write_text_section(output, index_count / 3, 2 + 3 * 24, [&](char* out, size_t t) {
+                *out++ = 'f';
+                for (int i = 0; i < 3; i++) {
+                    uint32_t index = remap[indices[t * 3 + i]] + 1;
+                    *out++ = ' ';
+                    out = append_uint(out, index);
+                    *out++ = '/';
+                    *out++ = '/';
+                    out = append_uint(out, index);
+                }
+                *out++ = '\n';
+                return out;
+            });
+            triangles += index_count / 3;
+            chunks++;
+            std::swap(previous, current);
+        }
+    }
+
+    std::cout << "Welded " << chunks << " chunks: " << next_vertex << " vertices ("
+              << welded << " shared), " << triangles << " triangles" << std::endl;
+    return output.good();
+}
@@ -0,0 +1,240 @@
+#include "../headers/Mesh_Meshlets.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+void compute_bounding_sphere(const MeshBuffers& mesh, const uint32_t* vertices, size_t count, float center[3], float& radius) {
+    auto position = [&](size_t i) { return &mesh.positions[vertices[i] * 3]; };
+    auto distance2 = [](const float* a, const float* b) {
+        float dx = a[0] - b[0], dy = a[1] - b[1], dz = a[2] - b[2];
+        return dx * dx + dy * dy + dz * dz;
+    };
+
+    // Esfera de Ritter: diámetro inicial entre dos puntos alejados y luego se expande
+    size_t first = 0;
+    for (size_t i = 1; i < count; i++) {
+        if (distance2(position(i), position(0)) > distance2(position(first), position(0))) {
+            first = i;
+        }
+    }
+    size_t second = first;
+    for (size_t i = 0; i < count; i++) {
+        if (distance2(position(i), position(first)) > distance2(position(second), position(first))) {
+            second = i;
+        }
+    }
+
+    for (int k = 0; k < 3; k++) {
+        center[k] = (position(first)[k] + position(second)[k]) * 0.5f;
+    }
+    radius = std::sqrt(distance2(position(first), position(second))) * 0.5f;
+
+    for (size_t i = 0; i < count; i++) {
+        float d = std::sqrt(distance2(position(i), center));
+        if (d > radius) {
+            float new_radius = (radius + d) * 0.5f;
+            float shift = (new_radius - radius) / d;
+            for (int k = 0; k < 3; k++) {
+                center[k] += (position(i)[k] - center[k]) * shift;
+            }
+            radius = new_radius;
+        }
+    }
+}
+
+void compute_normal_cone(const MeshBuffers& mesh, const MeshletData& data, const Meshlet& meshlet, float axis[3], float& cutoff) {
+    std::vector<float> normals;
+    normals.reserve(meshlet.triangle_count * 3);
+    float sum[3] = { 0.0f, 0.0f, 0.0f };
+
+    for (uint32_t t = 0; t < meshlet.triangle_count; t++) {
+        const uint8_t* tri = &data.triangles[(meshlet.triangle_offset + t) * 3];
+        const float* a = &mesh.positions[data.vertices[meshlet.vertex_offset + tri[0]] * 3];
+        const float* b = &mesh.positions[data.vertices[meshlet.vertex_offset + tri[1]] * 3];
+        const float* c = &mesh.positions[data.vertices[meshlet.vertex_offset + tri[2]] * 3];
+
+        float e1[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+        float e2[3] = { c[0] - a[0], c[1] - a[1], c[2] - a[2] };
+        float n[3] = {
+            e1[1] * e2[2] - e1[2] * e2[1],
+            e1[2] * e2[0] - e1[0] * e2[2],
+            e1[0] * e2[1] - e1[1] * e2[0]
+        };
+        float length = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+        if (length <= 0.0f) {
+            continue;
+        }
+        for (int k = 0; k < 3; k++) {
+            normals.push_back(n[k] / length);
+            sum[k] += n[k] / length;
+        }
+    }
+
+    axis[0] = axis[1] = axis[2] = 0.0f;
+    cutoff = 1.0f;
+
+    float length = std::sqrt(sum[0] * sum[0] + sum[1] * sum[1] + sum[2] * sum[2]);
+    if (normals.empty() || length <= 0.0f) {
+        return;
+    }
+
+    float min_dot = 1.0f;
+    for (size_t i = 0; i < normals.size(); i += 3) {
+        float dot = (normals[i] * sum[0] + normals[i + 1] * sum[1] + normals[i + 2] * sum[2]) / length;
+        min_dot = std::min(min_dot, dot);
+    }
+
+    // Con normales muy dispersas el cono no descarta nada y se deja deshabilitado
+    if (min_dot <= 0.1f) {
+        return;
+    }
+    for (int k = 0; k < 3; k++) {
+        axis[k] = sum[k] / length;
+    }
+    cutoff = std::sqrt(1.0f - min_dot * min_dot);
+}
+
+}
+
+MeshletData build_meshlets(const MeshBuffers& mesh, size_t max_vertices, size_t max_triangles) {
+    MeshletData data;
+    size_t triangle_count = mesh.triangle_count();
+    size_t vertex_count = mesh.vertex_count();
+    max_vertices = std::min<size_t>(std::max<size_t>(max_vertices, 3), 255);
+    max_triangles = std::max<size_t>(max_triangles, 1);
+    if (triangle_count == 0) {
+        return data;
+    }
+
+    std::vector<uint32_t> offsets(vertex_count + 1, 0);
+    for (uint32_t index : mesh.indices) {
+        offsets[index + 1]++;
+    }
+    for (size_t v = 0; v < vertex_count; v++) {
+        offsets[v + 1] += offsets[v];
+    }
+    std::vector<uint32_t> adjacency(mesh.indices.size());
+    std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+    for (size_t i = 0; i < mesh.indices.size(); i++) {
+        adjacency[fill[mesh.indices[i]]++] = (uint32_t)(i / 3);
+    }
+
+    const uint8_t unused_vertex = 0xff;
+    std::vector<uint8_t> local_index(vertex_count, unused_vertex);
+    std::vector<uint8_t> used(triangle_count, 0);
+    size_t seed_cursor = 0;
+
+    size_t next_seed = triangle_count;
+
+    while (true) {
+        // La semilla es un triángulo libre vecino del meshlet anterior; así no quedan huecos aislados
+        size_t seed = next_seed;
+        if (seed == triangle_count || used[seed]) {
+            while (seed_cursor < triangle_count && used[seed_cursor]) {
+                seed_cursor++;
+            }
+            if (seed_cursor == triangle_count) {
+                break;
+            }
+            seed = seed_cursor;
+        }
+
+        Meshlet meshlet = {};
+        meshlet.vertex_offset = (uint32_t)data.vertices.size();
+        meshlet.triangle_offset = (uint32_t)(data.triangles.size() / 3);
+        float centroid_sum[3] = { 0.0f, 0.0f, 0.0f };
+
+        auto add_triangle = [&](size_t t) {
+            used[t] = 1;
+            for (int k = 0; k < 3; k++) {
+                uint32_t vertex = mesh.indices[t * 3 + k];
+                if (local_index[vertex] == unused_vertex) {
+                    local_index[vertex] = (uint8_t)meshlet.vertex_count++;
+                    data.vertices.push_back(vertex);
+                    for (int c = 0; c < 3; c++) {
+                        centroid_sum[c] += mesh.positions[vertex * 3 + c];
+                    }
+                }
+                data.triangles.push_back(local_index[vertex]);
+            }
+            meshlet.triangle_count++;
+        };
+
+        add_triangle(seed);
+
+        // Crecimiento voraz: se prefiere el triángulo vecino que agrega menos vértices y está más cerca del centro
+        while (meshlet.triangle_count < max_triangles) {
+            size_t best = triangle_count;
+            int best_new = 4;
+            float best_distance = 0.0f;
+            float centroid[3] = {
+                centroid_sum[0] / meshlet.vertex_count,
+                centroid_sum[1] / meshlet.vertex_count,
+                centroid_sum[2] / meshlet.vertex_count
+            };
+
+            for (uint32_t i = 0; i < meshlet.vertex_count; i++) {
+                uint32_t vertex = data.vertices[meshlet.vertex_offset + i];
+                for (uint32_t a = offsets[vertex]; a < offsets[vertex + 1]; a++) {
+                    uint32_t t = adjacency[a];
+                    if (used[t]) {
+                        continue;
+                    }
+
+                    int new_vertices = 0;
+                    float distance = 0.0f;
+                    for (int k = 0; k < 3; k++) {
+                        uint32_t corner = mesh.indices[t * 3 + k];
+                        new_vertices += local_index[corner] == unused_vertex;
+                        for (int c = 0; c < 3; c++) {
+                            float d = mesh.positions[corner * 3 + c] - centroid[c];
+                            distance += d * d;
+                        }
+                    }
+                    if (meshlet.vertex_count + new_vertices > max_vertices) {
+                        continue;
+                    }
+                    if (new_vertices < best_new || (new_vertices == best_new && distance < best_distance)) {
+                        best = t;
+                        best_new = new_vertices;
+                        best_distance = distance;
+                    }
+                }
+            }
+
+            if (best == triangle_count) {
+                break;
+            }
+            add_triangle(best);
+        }
+
+        next_seed = triangle_count;
+        uint32_t best_free = UINT32_MAX;
+        for (uint32_t i = 0; i < meshlet.vertex_count; i++) {
+            uint32_t vertex = data.vertices[meshlet.vertex_offset + i];
+            local_index[vertex] = unused_vertex;
+
+            // Se prefiere el vecino cuyo vértice tenga menos triángulos libres: el borde más encerrado
+            uint32_t free_count = 0;
+            size_t candidate = triangle_count;
+            for (uint32_t a = offsets[vertex]; a < offsets[vertex + 1]; a++) {
+                if (!used[adjacency[a]]) {
+                    free_count++;
+                    candidate = adjacency[a];
+                }
+            }
+            if (candidate != triangle_count && free_count < best_free) {
+                best_free = free_count;
+                next_seed = candidate;
+            }
+        }
+
+        compute_bounding_sphere(mesh, &data.vertices[meshlet.vertex_offset], meshlet.vertex_count, meshlet.center, meshlet.radius);
+        compute_normal_cone(mesh, data, meshlet, meshlet.cone_axis, meshlet.cone_cutoff);
+        data.meshlets.push_back(meshlet);
+    }
+
+    return data;
+}
@@ -0,0 +1,364 @@
+#include "../headers/Mesh_Optimization.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace {
+
+const int vertex_cache_size = 32;
+const int max_valence = 32;
+
+struct VertexScoreTable {
+    float cache[vertex_cache_size + 1];
+    float valence[max_valence + 1];
+
+    VertexScoreTable() {
+        // Los tres vértices del último triángulo reciben un puntaje fijo para no favorecer tiras
+        for (int i = 0; i < vertex_cache_size; i++) {
+            if (i < 3) {
+                cache[i] = 0.75f;
+            } else {
+                float scaler = 1.0f - (float)(i - 3) / (float)(vertex_cache_size - 3);
+                cache[i] = std::pow(scaler, 1.5f);
+            }
+        }
+        cache[vertex_cache_size] = 0.0f;
+
+        valence[0] = 0.0f;
+        for (int i = 1; i <= max_valence; i++) {
+            valence[i] = 2.0f / std::sqrt((float)i);
+        }
+    }
+
+    float score(int cache_position, uint32_t live_triangles) const {
+        if (live_triangles == 0) {
+            return -1.0f;
+        }
+        int position = cache_position < 0 ? vertex_cache_size : cache_position;
+        return cache[position] + valence[std::min<uint32_t>(live_triangles, max_valence)];
+    }
+};
+
+struct TriangleAdjacency {
+    std::vector<uint32_t> offsets;
+    std::vector<uint32_t> counts;
+    std::vector<uint32_t> triangles;
+
+    void build(const std::vector<uint32_t>& indices, size_t vertex_count) {
+        counts.assign(vertex_count, 0);
+        for (uint32_t index : indices) {
+            counts[index]++;
+        }
+
+        offsets.assign(vertex_count + 1, 0);
+        for (size_t v = 0; v < vertex_count; v++) {
+            offsets[v + 1] = offsets[v] + counts[v];
+        }
+
+        triangles.resize(indices.size());
+        std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+        for (size_t i = 0; i < indices.size(); i++) {
+            triangles[fill[indices[i]]++] = (uint32_t)(i / 3);
+        }
+    }
+
+    // Los triángulos vivos de cada vértice se mantienen al inicio de su rango
+    void remove(uint32_t vertex, uint32_t triangle) {
+        uint32_t* begin = triangles.data() + offsets[vertex];
+        uint32_t* end = begin + counts[vertex];
+        uint32_t* it = std::find(begin, end, triangle);
+        if (it != end) {
+            *it = *(end - 1);
+            counts[vertex]--;
+        }
+    }
+};
+
+}
+
+void optimize_vertex_cache(std::vector<uint32_t>& indices, size_t vertex_count) {
+    size_t triangle_count = indices.size() / 3;
+    if (triangle_count == 0) {
+        return;
+    }
+
+    static const VertexScoreTable table;
+
+    TriangleAdjacency adjacency;
+    adjacency.build(indices, vertex_count);
+
+    std::vector<int> cache_position(vertex_count, -1);
+    std::vector<float> vertex_scores(vertex_count);
+    for (size_t v = 0; v < vertex_count; v++) {
+        vertex_scores[v] = table.score(-1, adjacency.counts[v]);
+    }
+
+    std::vector<float> triangle_scores(triangle_count);
+    std::vector<uint8_t> emitted(triangle_count, 0);
+    for (size_t t = 0; t < triangle_count; t++) {
+        const uint32_t* tri = &indices[t * 3];
+        triangle_scores[t] = vertex_scores[tri[0]] + vertex_scores[tri[1]] + vertex_scores[tri[2]];
+    }
+
+    uint32_t best = (uint32_t)(std::max_element(triangle_scores.begin(), triangle_scores.end()) - triangle_scores.begin());
+
+    std::vector<uint32_t> result;
+    result.reserve(indices.size());
+
+    std::vector<uint32_t> cache;
+    std::vector<uint32_t> next_cache;
+    cache.reserve(vertex_cache_size + 3);
+    next_cache.reserve(vertex_cache_size + 3);
+
+    size_t scan_cursor = 0;
+
+    for (size_t emitted_count = 0; emitted_count < triangle_count; emitted_count++) {
+        if (best == UINT32_MAX) {
+            // Ningún vértice en caché tiene triángulos pendientes: se continúa con el siguiente sin emitir
+            while (emitted[scan_cursor]) {
+                scan_cursor++;
+            }
+            best = (uint32_t)scan_cursor;
+        }
+
+        const uint32_t tri[3] = { indices[best * 3], indices[best * 3 + 1], indices[best * 3 + 2] };
+        result.insert(result.end(), tri, tri + 3);
+        emitted[best] = 1;
+
+        next_cache.clear();
+        next_cache.insert(next_cache.end(), tri, tri + 3);
+        for (uint32_t vertex : cache) {
+            if (vertex != tri[0] && vertex != tri[1] && vertex != tri[2]) {
+                next_cache.push_back(vertex);
+            }
+        }
+
+        for (uint32_t vertex : tri) {
+            adjacency.remove(vertex, best);
+        }
+
+        for (size_t i = vertex_cache_size; i < next_cache.size(); i++) {
+            cache_position[next_cache[i]] = -1;
+        }
+
+        // Se actualizan los puntajes de los vértices que entraron, se movieron o salieron de la caché
+        best = UINT32_MAX;
+        float best_score = -1.0f;
+        for (size_t i = 0; i < next_cache.size(); i++) {
+            uint32_t vertex = next_cache[i];
+            if (i < (size_t)vertex_cache_size) {
+                cache_position[vertex] = (int)i;
+            }
+
+            float score = table.score(cache_position[vertex], adjacency.counts[vertex]);
+            float delta = score - vertex_scores[vertex];
+            vertex_scores[vertex] = score;
+
+            const uint32_t* begin = adjacency.triangles.data() + adjacency.offsets[vertex];
+            for (uint32_t k = 0; k < adjacency.counts[vertex]; k++) {
+                uint32_t triangle = begin[k];
+                triangle_scores[triangle] += delta;
+                if (i < (size_t)vertex_cache_size && triangle_scores[triangle] > best_score) {
+                    best_score = triangle_scores[triangle];
+                    best = triangle;
+                }
+            }
+        }
+
+        if (next_cache.size() > (size_t)vertex_cache_size) {
+            next_cache.resize(vertex_cache_size);
+        }
+        cache.swap(next_cache);
+    }
+
+    indices.swap(result);
+}
+
+double average_cache_miss_ratio(const std::vector<uint32_t>& indices, size_t vertex_count, size_t cache_size) {
+    size_t triangle_count = indices.size() / 3;
+    if (triangle_count == 0) {
+        return 0.0;
+    }
+
+    // Caché FIFO simulada con marcas de tiempo: un vértice sigue en caché si entró hace menos de cache_size fallos
+    std::vector<size_t> timestamps(vertex_count, 0);
+    size_t time = cache_size + 1;
+    size_t misses = 0;
+    for (uint32_t index : indices) {
+        if (time - timestamps[index] > cache_size) {
+            timestamps[index] = time++;
+            misses++;
+        }
+    }
+    return (double)misses / (double)triangle_count;
+}
+
+void optimize_overdraw(std::vector<uint32_t>& indices, const std::vector<float>& positions, size_t vertex_count, float threshold) {
+    size_t triangle_count = indices.size() / 3;
+    if (triangle_count == 0) {
+        return;
+    }
+
+    const size_t cache_size = 16;
+    std::vector<size_t> timestamps(vertex_count, 0);
+    size_t time = cache_size + 1;
+
+    auto triangle_misses = [&](size_t t) {
+        int misses = 0;
+        for (int k = 0; k < 3; k++) {
+            uint32_t index = indices[t * 3 + k];
+            if (time - timestamps[index] > cache_size) {
+                timestamps[index] = time++;
+                misses++;
+            }
+        }
+        return misses;
+    };
+    auto reset_cache = [&]() {
+        time += cache_size + 1;
+    };
+
+    // Límites duros: triángulos cuyos tres vértices fallan, donde el orden de caché ya se reinició
+    std::vector<size_t> hard_boundaries;
+    for (size_t t = 0; t < triangle_count; t++) {
+        if (triangle_misses(t) == 3) {
+            hard_boundaries.push_back(t);
+        }
+    }
+    hard_boundaries.push_back(triangle_count);
+
+    // Límites suaves: dentro de cada cluster duro se corta cuando el ACMR acumulado ya es cercano al del cluster
+    std::vector<size_t> clusters;
+    for (size_t h = 0; h + 1 < hard_boundaries.size(); h++) {
+        size_t begin = hard_boundaries[h];
+        size_t end = hard_boundaries[h + 1];
+
+        reset_cache();
+        size_t cluster_misses = 0;
+        for (size_t t = begin; t < end; t++) {
+            cluster_misses += triangle_misses(t);
+        }
+        double cluster_acmr = (double)cluster_misses / (double)(end - begin);
+
+        reset_cache();
+        clusters.push_back(begin);
+        size_t start = begin;
+        size_t running_misses = 0;
+        for (size_t t = begin; t < end; t++) {
+            running_misses += triangle_misses(t);
+            double running_acmr = (double)running_misses / (double)(t - start + 1);
+            if (t + 1 < end && running_acmr <= cluster_acmr * threshold) {
+                clusters.push_back(t + 1);
+                start = t + 1;
+                running_misses = 0;
+                reset_cache();
+            }
+        }
+    }
+    clusters.push_back(triangle_count);
+
+    size_t cluster_count = clusters.size() - 1;
+    std::vector<float> centroids(cluster_count * 3, 0.0f);
+    std::vector<float> cluster_normals(cluster_count * 3, 0.0f);
+    std::vector<float> areas(cluster_count, 0.0f);
+    double mesh_centroid[3] = { 0.0, 0.0, 0.0 };
+    double mesh_area = 0.0;
+
+    for (size_t c = 0; c < cluster_count; c++) {
+        for (size_t t = clusters[c]; t < clusters[c + 1]; t++) {
+            const float* a = &positions[indices[t * 3] * 3];
+            const float* b = &positions[indices[t * 3 + 1] * 3];
+            const float* d = &positions[indices[t * 3 + 2] * 3];
+
+            float e1[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+            float e2[3] = { d[0] - a[0], d[1] - a[1], d[2] - a[2] };
+            float normal[3] = {
+                e1[1] * e2[2] - e1[2] * e2[1],
+                e1[2] * e2[0] - e1[0] * e2[2],
+                e1[0] * e2[1] - e1[1] * e2[0]
+            };
+            float area = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+
+            for (int k = 0; k < 3; k++) {
+                float center = (a[k] + b[k] + d[k]) / 3.0f;
+                centroids[c * 3 + k] += center * area;
+                cluster_normals[c * 3 + k] += normal[k];
+                mesh_centroid[k] += center * area;
+            }
+            areas[c] += area;
+            mesh_area += area;
+        }
+    }
+
+    if (mesh_area > 0.0) {
+        for (int k = 0; k < 3; k++) {
+            mesh_centroid[k] /= mesh_area;
+        }
+    }
+
+    // Los clusters más alejados del centro en la dirección de su normal se dibujan primero
+    std::vector<float> sort_keys(cluster_count, 0.0f);
+    for (size_t c = 0; c < cluster_count; c++) {
+        if (areas[c] <= 0.0f) {
+            continue;
+        }
+        const float* normal = &cluster_normals[c * 3];
+        float length = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+        if (length <= 0.0f) {
+            continue;
+        }
+        float key = 0.0f;
+        for (int k = 0; k < 3; k++) {
+            key += (centroids[c * 3 + k] / areas[c] - (float)mesh_centroid[k]) * normal[k] / length;
+        }
+        sort_keys[c] = key;
+    }
+
+    std::vector<uint32_t> order(cluster_count);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+        return sort_keys[a] > sort_keys[b];
+    });
+
+    std::vector<uint32_t> result;
+    result.reserve(indices.size());
+    for (uint32_t c : order) {
+        result.insert(result.end(), indices.begin() + clusters[c] * 3, indices.begin() + clusters[c + 1] * 3);
+    }
+    indices.swap(result);
+}
+
+void optimize_vertex_fetch(MeshBuffers& mesh) {
+    size_t vertex_count = mesh.vertex_count();
+    bool has_normals = mesh.normals.size() == mesh.positions.size();
+
+    std::vector<uint32_t> remap(vertex_count, UINT32_MAX);
+    std::vector<float> positions;
+    std::vector<float> normals;
+    positions.reserve(mesh.positions.size());
+    if (has_normals) {
+        normals.reserve(mesh.normals.size());
+    }
+
+    // Los vértices no referenciados se descartan
+    for (uint32_t& index : mesh.indices) {
+        if (remap[index] == UINT32_MAX) {
+            remap[index] = (uint32_t)(positions.size() / 3);
+            positions.insert(positions.end(), mesh.positions.begin() + index * 3, mesh.positions.begin() + index * 3 + 3);
+            if (has_normals) {
+                normals.insert(normals.end(), mesh.normals.begin() + index * 3, mesh.normals.begin() + index * 3 + 3);
+            }
+        }
+        index = remap[index];
+    }
+
+    mesh.positions.swap(positions);
+    mesh.normals.swap(normals);
+}
+
+void optimize_mesh(MeshBuffers& mesh) {
+    optimize_vertex_cache(mesh.indices, mesh.vertex_count());
+    optimize_overdraw(mesh.indices, mesh.positions, mesh.vertex_count());
+    optimize_vertex_fetch(mesh);
+}
@@ -0,0 +1,423 @@
+#include "../headers/Mesh_Simplification.h"
+
+#include <vector>
+#include <queue>
+#include <algorithm>
+#include <cmath>
+#include <Eigen/Dense>
+
+namespace {
+
+struct Quadric {
+    // Matriz simétrica 4x4: a00 a01 a02 a03 a11 a12 a13 a22 a23 a33
+    double a[10] = {};
+
+    void add_plane(double nx, double ny, double nz, double d, double weight) {
+        a[0] += weight * nx * nx; a[1] += weight * nx * ny; a[2] += weight * nx * nz; a[3] += weight * nx * d;
+        a[4] += weight * ny * ny; a[5] += weight * ny * nz; a[6] += weight * ny * d;
+        a[7] += weight * nz * nz; a[8] += weight * nz * d;
+        a[9] += weight * d * d;
+    }
+
+    Quadric& operator+=(const Quadric& other) {
+        for (int i = 0; i < 10; i++) {
+            a[i] += other.a[i];
+        }
+        return *this;
+    }
+
+    double evaluate(double x, double y, double z) const {
+        return a[0] * x * x + 2 * a[1] * x * y + 2 * a[2] * x * z + 2 * a[3] * x
+             + a[4] * y * y + 2 * a[5] * y * z + 2 * a[6] * y
+             + a[7] * z * z + 2 * a[8] * z
+             + a[9];
+    }
+
+    bool optimal_point(Eigen::Vector3d& point) const {
+        Eigen::Matrix3d matrix;
+        matrix << a[0], a[1], a[2],
+                  a[1], a[4], a[5],
+                  a[2], a[5], a[7];
+        Eigen::FullPivLU<Eigen::Matrix3d> lu(matrix);
+        lu.setThreshold(1e-8);
+        if (!lu.isInvertible()) {
+            return false;
+        }
+        point = lu.solve(Eigen::Vector3d(-a[3], -a[6], -a[8]));
+        return point.allFinite();
+    }
+};
+
+struct EdgeCandidate {
+    double cost;
+    uint32_t u, v;
+    uint32_t stamp_u, stamp_v;
+    float position[3];
+
+    bool operator<(const EdgeCandidate& other) const {
+        return cost > other.cost;
+    }
+};
+
+class QuadricSimplifier {
+    private:
+        std::vector<float> positions;
+        std::vector<uint32_t> faces;
+        std::vector<uint8_t> face_alive;
+        std::vector<uint8_t> vertex_alive;
+        std::vector<uint32_t> stamps;
+        std::vector<Quadric> quadrics;
+        std::vector<std::vector<uint32_t>> vertex_faces;
+        std::priority_queue<EdgeCandidate> heap;
+        size_t alive_triangles;
+
+        Eigen::Vector3d vertex(uint32_t index) const {
+            return Eigen::Vector3d(positions[index * 3], positions[index * 3 + 1], positions[index * 3 + 2]);
+        }
+
+        Eigen::Vector3d face_cross(uint32_t face, uint32_t moved, const Eigen::Vector3d& moved_position) const {
+            Eigen::Vector3d corners[3];
+            for (int i = 0; i < 3; i++) {
+                uint32_t index = faces[face * 3 + i];
+                corners[i] = index == moved ? moved_position : vertex(index);
+            }
+            return (corners[1] - corners[0]).cross(corners[2] - corners[0]);
+        }
+
+        void build_quadrics(bool preserve_boundary);
+        void push_candidate(uint32_t u, uint32_t v);
+        void collect_neighbors(uint32_t vertex_index, std::vector<uint32_t>& neighbors) const;
+        bool is_valid_collapse(uint32_t u, uint32_t v, const Eigen::Vector3d& position);
+        void collapse(uint32_t u, uint32_t v, const float position[3]);
+
+        std::vector<uint32_t> neighbors_u, neighbors_v;
+
+    public:
+        QuadricSimplifier(const MeshBuffers& mesh, bool preserve_boundary);
+        void run(const SimplificationOptions& options, SimplificationStats& stats);
+        MeshBuffers build_result() const;
+};
+
+QuadricSimplifier::QuadricSimplifier(const MeshBuffers& mesh, bool preserve_boundary)
+    : positions(mesh.positions), faces(mesh.indices) {
+    size_t vertex_count = mesh.vertex_count();
+    face_alive.assign(mesh.triangle_count(), 1);
+    vertex_alive.assign(vertex_count, 1);
+    stamps.assign(vertex_count, 0);
+    quadrics.assign(vertex_count, Quadric());
+    alive_triangles = mesh.triangle_count();
+
+    // Adyacencia vértice-cara en dos pasadas para reservar exacto
+    std::vector<uint32_t> face_counts(vertex_count, 0);
+    for (uint32_t index : faces) {
+        face_counts[index]++;
+    }
+    vertex_faces.resize(vertex_count);
+    for (size_t v = 0; v < vertex_count; v++) {
+        vertex_faces[v].reserve(face_counts[v]);
+    }
+    for (size_t f = 0; f < face_alive.size(); f++) {
+        for (int i = 0; i < 3; i++) {
+            vertex_faces[faces[f * 3 + i]].push_back((uint32_t)f);
+        }
+    }
+
+    build_quadrics(preserve_boundary);
+}
+
+void QuadricSimplifier::build_quadrics(bool preserve_boundary) {
+    struct Edge {
+        uint32_t a, b, face;
+        bool operator<(const Edge& other) const {
+            return a != other.a ? a < other.a : b < other.b;
+        }
+    };
+
+    std::vector<Edge> edges;
+    edges.reserve(faces.size());
+
+    for (uint32_t f = 0; f < face_alive.size(); f++) {
+        Eigen::Vector3d normal = face_cross(f, ~0u, Eigen::Vector3d::Zero());
+        double length = normal.norm();
+        if (length > 0) {
+            normal /= length;
+            double d = -normal.dot(vertex(faces[f * 3]));
+            for (int i = 0; i < 3; i++) {
+                quadrics[faces[f * 3 + i]].add_plane(normal.x(), normal.y(), normal.z(), d, 1.0);
+            }
+        }
+
+        for (int i = 0; i < 3; i++) {
+            uint32_t a = faces[f * 3 + i];
+            uint32_t b = faces[f * 3 + (i + 1) % 3];
+            edges.push_back({ std::min(a, b), std::max(a, b), f });
+        }
+    }
+
+    std::sort(edges.begin(), edges.end());
+
+    for (size_t i = 0; i < edges.size();) {
+        size_t j = i;
+        while (j < edges.size() && edges[j].a == edges[i].a && edges[j].b == edges[i].b) {
+            j++;
+        }
+
+        // Una arista usada por una sola cara es borde: se agrega un plano perpendicular con peso alto
+        if (preserve_boundary && j - i == 1) {
+            uint32_t face = edges[i].face;
+            Eigen::Vector3d face_normal = face_cross(face, ~0u, Eigen::Vector3d::Zero());
+            Eigen::Vector3d a = vertex(edges[i].a);
+            Eigen::Vector3d b = vertex(edges[i].b);
+            Eigen::Vector3d normal = (b - a).cross(face_normal);
+            double length = normal.norm();
+            if (length > 0) {
+                normal /= length;
+                double d = -normal.dot(a);
+                quadrics[edges[i].a].add_plane(normal.x(), normal.y(), normal.z(), d, 1000.0);
+                quadrics[edges[i].b].add_plane(normal.x(), normal.y(), normal.z(), d, 1000.0);
+            }
+        }
+
+        push_candidate(edges[i].a, edges[i].b);
+        i = j;
+    }
+}
+
+void QuadricSimplifier::push_candidate(uint32_t u, uint32_t v) {
+    Quadric quadric = quadrics[u];
+    quadric += quadrics[v];
+
+    EdgeCandidate candidate;
+    candidate.u = u;
+    candidate.v = v;
+    candidate.stamp_u = stamps[u];
+    candidate.stamp_v = stamps[v];
+
+    Eigen::Vector3d best;
+    double best_cost;
+    if (quadric.optimal_point(best)) {
+        best_cost = quadric.evaluate(best.x(), best.y(), best.z());
+    } else {
+        Eigen::Vector3d options[3] = { vertex(u), vertex(v), (vertex(u) + vertex(v)) * 0.5 };
+        best = options[0];
+        best_cost = quadric.evaluate(best.x(), best.y(), best.z());
+        for (int i = 1; i < 3; i++) {
+            double cost = quadric.evaluate(options[i].x(), options[i].y(), options[i].z());
+            if (cost < best_cost) {
+                best_cost = cost;
+                best = options[i];
+            }
+        }
+    }
+
+    candidate.cost = std::max(best_cost, 0.0);
+    candidate.position[0] = (float)best.x();
+    candidate.position[1] = (float)best.y();
+    candidate.position[2] = (float)best.z();
+    heap.push(candidate);
+}
+
+void QuadricSimplifier::collect_neighbors(uint32_t vertex_index, std::vector<uint32_t>& neighbors) const {
+    neighbors.clear();
+    for (uint32_t face : vertex_faces[vertex_index]) {
+        if (!face_alive[face]) {
+            continue;
+        }
+        for (int i = 0; i < 3; i++) {
+            uint32_t other = faces[face * 3 + i];
+            if (other != vertex_index) {
+                neighbors.push_back(other);
+            }
+        }
+    }
+    std::sort(neighbors.begin(), neighbors.end());
+    neighbors.erase(std::unique(neighbors.begin(), neighbors.end()), neighbors.end());
+}
+
+bool QuadricSimplifier::is_valid_collapse(uint32_t u, uint32_t v, const Eigen::Vector3d& position) {
+    // Condición de enlace: los vecinos comunes deben ser exactamente los de las caras compartidas
+    collect_neighbors(u, neighbors_u);
+    collect_neighbors(v, neighbors_v);
+
+    size_t shared_faces = 0;
+    for (uint32_t face : vertex_faces[u]) {
+        if (face_alive[face] &&
+            (faces[face * 3] == v || faces[face * 3 + 1] == v || faces[face * 3 + 2] == v)) {
+            shared_faces++;
+        }
+    }
+
+    size_t common = 0;
+    for (size_t i = 0, j = 0; i < neighbors_u.size() && j < neighbors_v.size();) {
+        if (neighbors_u[i] < neighbors_v[j]) {
+            i++;
+        } else if (neighbors_u[i] > neighbors_v[j]) {
+            j++;
+        } else {
+            common++;
+            i++;
+            j++;
+        }
+    }
+    if (common != shared_faces) {
+        return false;
+    }
+
+    // Ninguna cara restante puede invertirse ni degenerar
+    for (uint32_t moved : { u, v }) {
+        for (uint32_t face : vertex_faces[moved]) {
+            if (!face_alive[face]) {
+                continue;
+            }
+            const uint32_t* corners = &faces[face * 3];
+            bool has_u = corners[0] == u || corners[1] == u || corners[2] == u;
+            bool has_v = corners[0] == v || corners[1] == v || corners[2] == v;
+            if (has_u && has_v) {
+                continue;
+            }
+
+            Eigen::Vector3d before = face_cross(face, ~0u, Eigen::Vector3d::Zero());
+            Eigen::Vector3d after = face_cross(face, moved, position);
+            double before_length = before.norm();
+            double after_length = after.norm();
+            if (after_length <= 1e-12 || before_length <= 1e-12) {
+                return false;
+            }
+            if (before.dot(after) < 0.2 * before_length * after_length) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void QuadricSimplifier::collapse(uint32_t u, uint32_t v, const float position[3]) {
+    positions[u * 3] = position[0];
+    positions[u * 3 + 1] = position[1];
+    positions[u * 3 + 2] = position[2];
+    quadrics[u] += quadrics[v];
+
+    for (uint32_t face : vertex_faces[v]) {
+        if (!face_alive[face]) {
+            continue;
+        }
+        uint32_t* corners = &faces[face * 3];
+        if (corners[0] == u || corners[1] == u || corners[2] == u) {
+            face_alive[face] = 0;
+            alive_triangles--;
+            continue;
+        }
+        for (int i = 0; i < 3; i++) {
+            if (corners[i] == v) {
+                corners[i] = u;
+            }
+        }
+        vertex_faces[u].push_back(face);
+    }
+
+    vertex_alive[v] = 0;
+    vertex_faces[v].clear();
+    vertex_faces[v].shrink_to_fit();
+    stamps[u]++;
+
+    auto& incident = vertex_faces[u];
+    incident.erase(std::remove_if(incident.begin(), incident.end(),
+                                  [&](uint32_t face) { return !face_alive[face]; }),
+                   incident.end());
+
+    collect_neighbors(u, neighbors_u);
+    for (uint32_t neighbor : neighbors_u) {
+        push_candidate(u, neighbor);
+    }
+}
+
+void QuadricSimplifier::run(const SimplificationOptions& options, SimplificationStats& stats) {
+    while (!heap.empty() && alive_triangles > options.target_triangles) {
+        EdgeCandidate candidate = heap.top();
+        heap.pop();
+
+        if (!vertex_alive[candidate.u] || !vertex_alive[candidate.v] ||
+            stamps[candidate.u] != candidate.stamp_u || stamps[candidate.v] != candidate.stamp_v) {
+            continue;
+        }
+        if (options.max_error > 0.0 && candidate.cost > options.max_error * options.max_error) {
+            break;
+        }
+
+        Eigen::Vector3d position(candidate.position[0], candidate.position[1], candidate.position[2]);
+        if (!is_valid_collapse(candidate.u, candidate.v, position)) {
+            continue;
+        }
+
+        collapse(candidate.u, candidate.v, candidate.position);
+        stats.collapses++;
+        stats.max_error = std::max(stats.max_error, std::sqrt(candidate.cost));
+    }
+}
+
+MeshBuffers QuadricSimplifier::build_result() const {
+    MeshBuffers result;
+    std::vector<uint32_t> remap(vertex_alive.size(), ~0u);
+
+    result.reserve(alive_triangles / 2 + 3, alive_triangles);
+    for (size_t f = 0; f < face_alive.size(); f++) {
+        if (!face_alive[f]) {
+            continue;
+        }
+        uint32_t corners[3];
+        for (int i = 0; i < 3; i++) {
+            uint32_t index = faces[f * 3 + i];
+            if (remap[index] == ~0u) {
+                remap[index] = result.add_vertex(positions[index * 3], positions[index * 3 + 1], positions[index * 3 + 2]);
+            }
+            corners[i] = remap[index];
+        }
+        result.add_triangle(corners[0], corners[1], corners[2]);
+    }
+
+    result.compute_vertex_normals();
+    return result;
+}
+
+}
+
+MeshBuffers simplify_mesh(const MeshBuffers& mesh, const SimplificationOptions& options, SimplificationStats* stats) {
+    SimplificationStats local_stats;
+    local_stats.input_triangles = mesh.triangle_count();
+
+    QuadricSimplifier simplifier(mesh, options.preserve_boundary);
+    simplifier.run(options, local_stats);
+    MeshBuffers result = simplifier.build_result();
+
+    local_stats.output_triangles = result.triangle_count();
+    if (stats) {
+        *stats = local_stats;
+    }
+    return result;
+}
+
+std::vector<LodLevel> build_lod_chain(const MeshBuffers& mesh, const std::vector<float>& ratios) {
+    std::vector<LodLevel> levels;
+    levels.reserve(ratios.size());
+
+    for (float ratio : ratios) {
+        const MeshBuffers& previous = levels.empty() ? mesh : levels.back().mesh;
+        float previous_error = levels.empty() ? 0.0f : levels.back().geometric_error;
+        size_t target = (size_t)(mesh.triangle_count() * (double)ratio);
+
+        LodLevel level;
+        level.triangle_ratio = ratio;
+        if (target >= previous.triangle_count()) {
+            level.geometric_error = previous_error;
+            level.mesh = previous;
+        } else {
+            SimplificationOptions options;
+            options.target_triangles = target;
+            SimplificationStats stats;
+            level.mesh = simplify_mesh(previous, options, &stats);
+            level.geometric_error = std::max(previous_error, (float)stats.max_error);
+        }
+        levels.push_back(std::move(level));
+    }
+    return levels;
+}
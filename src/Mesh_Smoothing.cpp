@@ -0,0 +1,94 @@
+#include "../headers/Mesh_Smoothing.h"
+#include "../headers/Parallel.h"
+
+#include <algorithm>
+
+void VertexAdjacency::build(const MeshBuffers& mesh) {
+    size_t vertex_count = mesh.vertex_count();
+
+    // Primero se reservan dos vecinos por triángulo incidente y luego se eliminan los repetidos
+    std::vector<uint32_t> counts(vertex_count + 1, 0);
+    for (uint32_t index : mesh.indices) {
+        counts[index + 1] += 2;
+    }
+    for (size_t v = 0; v < vertex_count; v++) {
+        counts[v + 1] += counts[v];
+    }
+
+    std::vector<uint32_t> raw(counts[vertex_count]);
+    std::vector<uint32_t> fill(counts.begin(), counts.end() - 1);
+    for (size_t t = 0; t < mesh.indices.size(); t += 3) {
+        const uint32_t* tri = &mesh.indices[t];
+        for (int k = 0; k < 3; k++) {
+            uint32_t vertex = tri[k];
+            raw[fill[vertex]++] = tri[(k + 1) % 3];
+            raw[fill[vertex]++] = tri[(k + 2) % 3];
+        }
+    }
+
+    std::vector<uint32_t> unique_counts(vertex_count, 0);
+    parallel_for(0, vertex_count, [&](size_t begin, size_t end, size_t) {
+        for (size_t v = begin; v < end; v++) {
+            uint32_t* first = raw.data() + counts[v];
+            uint32_t* last = raw.data() + counts[v + 1];
+            std::sort(first, last);
+            unique_counts[v] = (uint32_t)(std::unique(first, last) - first);
+        }
+    });
+
+    offsets.assign(vertex_count + 1, 0);
+    for (size_t v = 0; v < vertex_count; v++) {
+        offsets[v + 1] = offsets[v] + unique_counts[v];
+    }
+    neighbors.resize(offsets[vertex_count]);
+    parallel_for(0, vertex_count, [&](size_t begin, size_t end, size_t) {
+        for (size_t v = begin; v < end; v++) {
+            std::copy(raw.begin() + counts[v], raw.begin() + counts[v] + unique_counts[v], neighbors.begin() + offsets[v]);
+        }
+    });
+}
+
+void smooth_mesh_taubin(MeshBuffers& mesh, int iterations, float lambda, float mu) {
+    size_t vertex_count = mesh.vertex_count();
+    if (vertex_count == 0 || iterations <= 0) {
+        return;
+    }
+
+    VertexAdjacency adjacency;
+    adjacency.build(mesh);
+
+    std::vector<float> next(mesh.positions.size());
+    auto laplacian_step = [&](float factor) {
+        const std::vector<float>& current = mesh.positions;
+        parallel_for(0, vertex_count, [&](size_t begin, size_t end, size_t) {
+            for (size_t v = begin; v < end; v++) {
+                uint32_t first = adjacency.offsets[v];
+                uint32_t last = adjacency.offsets[v + 1];
+                if (first == last) {
+                    for (int k = 0; k < 3; k++) {
+                        next[v * 3 + k] = current[v * 3 + k];
+                    }
+                    continue;
+                }
+
+                float average[3] = { 0.0f, 0.0f, 0.0f };
+                for (uint32_t n = first; n < last; n++) {
+                    const float* neighbor = &current[adjacency.neighbors[n] * 3];
+                    average[0] += neighbor[0];
+                    average[1] += neighbor[1];
+                    average[2] += neighbor[2];
+                }
+                float inverse = 1.0f / (float)(last - first);
+                for (int k = 0; k < 3; k++) {
+                    next[v * 3 + k] = current[v * 3 + k] + factor * (average[k] * inverse - current[v * 3 + k]);
+                }
+            }
+        });
+        mesh.positions.swap(next);
+    };
+
+    for (int i = 0; i < iterations; i++) {
+        laplacian_step(lambda);
+        laplacian_step(mu);
+    }
+}
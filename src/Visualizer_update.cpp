@@ -10,22 +10,43 @@
 #include <sstream>
 #include <map>
 #include <algorithm>
+#include "../headers/Mesh_Export.h"
 
 struct Vertex {
     glm::vec3 position;
     glm::vec3 normal;
 };
 
+struct LodBuffers {
+    GLuint VAO, VBO, EBO;
+    GLsizei indexCount;
+    float error;
+};
+
+struct MeshletDraw {
+    glm::vec3 center;
+    float radius;
+    glm::vec3 coneAxis;
+    float coneCutoff;
+    GLsizei firstIndex;
+    GLsizei indexCount;
+};
+
 struct Mesh {
     std::vector<Vertex> vertices;
     std::vector<unsigned int> indices;
     GLuint VAO, VBO, EBO;
+    GLsizei indexCount;
+    std::vector<LodBuffers> lods;
+    std::vector<MeshletDraw> meshlets;
+    glm::mat4 normalization;
+    float normalizationScale;
     glm::vec3 color;
     glm::vec3 position;
     glm::vec3 scale;
     bool visible;
     
-    Mesh() : VAO(0), VBO(0), EBO(0), color(1.0f), position(0.0f), scale(1.0f), visible(false) {}
+    Mesh() : VAO(0), VBO(0), EBO(0), indexCount(0), normalization(1.0f), normalizationScale(1.0f), color(1.0f), position(0.0f), scale(1.0f), visible(false) {}
 };
 
 struct Organ {
@@ -300,7 +321,9 @@ class FrogAnatomyViewer {
         
         void loadModels() {
             for (const auto& organ : organInfo) {
-                if (loadOBJ("mallas/" + organ.filename, organ.name)) {
+                std::string stem = "mallas/" + organ.filename.substr(0, organ.filename.rfind('.'));
+                if (loadLodMesh(stem + ".rlod", organ.name) || loadNativeMesh(stem + ".rmesh", organ.name) ||
+                    loadCompressedMesh(stem + ".rcmp", organ.name) || loadOBJ("mallas/" + organ.filename, organ.name)) {
                     organs[organ.name].color = organ.color;
                     organs[organ.name].position = organ.anatomicalPosition;
                     organs[organ.name].scale = organ.anatomicalScale;
@@ -311,6 +334,155 @@ class FrogAnatomyViewer {
             }
         }
         
+        void setNormalization(Mesh& mesh, const float minBounds[3], const float maxBounds[3]) {
+            glm::vec3 minPos(minBounds[0], minBounds[1], minBounds[2]);
+            glm::vec3 maxPos(maxBounds[0], maxBounds[1], maxBounds[2]);
+            glm::vec3 center = (minPos + maxPos) * 0.5f;
+            float scale = glm::length(maxPos - minPos);
+            if (scale <= 0.0f) {
+                scale = 1.0f;
+            }
+            mesh.normalizationScale = scale;
+            mesh.normalization = glm::scale(glm::mat4(1.0f), glm::vec3(1.0f / scale)) * glm::translate(glm::mat4(1.0f), -center);
+        }
+        
+        // Los bloques del archivo mapeado se suben directamente a la GPU sin copias intermedias
+        void uploadBlocks(const float* positions, const float* normals, size_t vertexCount,
+                          const uint32_t* indices, size_t indexCount, GLuint& VAO, GLuint& VBO, GLuint& EBO) {
+            GLsizeiptr vertexBytes = (GLsizeiptr)(vertexCount * 3 * sizeof(float));
+            
+            glGenVertexArrays(1, &VAO);
+            glGenBuffers(1, &VBO);
+            glGenBuffers(1, &EBO);
+            
+            glBindVertexArray(VAO);
+            
+            glBindBuffer(GL_ARRAY_BUFFER, VBO);
+            glBufferData(GL_ARRAY_BUFFER, vertexBytes * 2, NULL, GL_STATIC_DRAW);
+            glBufferSubData(GL_ARRAY_BUFFER, 0, vertexBytes, positions);
+            glBufferSubData(GL_ARRAY_BUFFER, vertexBytes, vertexBytes, normals);
+            
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexCount * sizeof(uint32_t), indices, GL_STATIC_DRAW);
+            
+            glEnableVertexAttribArray(0);
+            glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+            
+            glEnableVertexAttribArray(1);
+            glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)vertexBytes);
+            
+            glBindVertexArray(0);
+        }
+        
+        bool loadNativeMesh(const std::string& filename, const std::string& name) {
+            NativeMeshView view;
+            if (!view.open(filename)) {
+                return false;
+            }
+            
+            Mesh& mesh = organs[name];
+            mesh.vertices.clear();
+            mesh.indices.clear();
+            setNormalization(mesh, view.get_header().min_bounds, view.get_header().max_bounds);
+            
+            if (view.meshlet_count() == 0) {
+                uploadBlocks(view.positions(), view.normals(), view.vertex_count(),
+                             view.indices(), view.index_count(), mesh.VAO, mesh.VBO, mesh.EBO);
+                mesh.indexCount = (GLsizei)view.index_count();
+            } else {
+                // Con meshlets el buffer de índices se arma en orden de meshlet para poder dibujar solo los visibles
+                std::vector<uint32_t> meshletIndices;
+                meshletIndices.reserve(view.get_header().meshlet_triangle_count * 3);
+                mesh.meshlets.clear();
+                for (size_t m = 0; m < view.meshlet_count(); m++) {
+                    const Meshlet& meshlet = view.meshlets()[m];
+                    MeshletDraw draw;
+                    draw.center = glm::vec3(meshlet.center[0], meshlet.center[1], meshlet.center[2]);
+                    draw.radius = meshlet.radius;
+                    draw.coneAxis = glm::vec3(meshlet.cone_axis[0], meshlet.cone_axis[1], meshlet.cone_axis[2]);
+                    draw.coneCutoff = meshlet.cone_cutoff;
+                    draw.firstIndex = (GLsizei)meshletIndices.size();
+                    draw.indexCount = (GLsizei)(meshlet.triangle_count * 3);
+                    
+                    const uint8_t* triangles = view.meshlet_triangles() + meshlet.triangle_offset * 3;
+                    for (uint32_t i = 0; i < meshlet.triangle_count * 3; i++) {
+                        meshletIndices.push_back(view.meshlet_vertices()[meshlet.vertex_offset + triangles[i]]);
+                    }
+                    mesh.meshlets.push_back(draw);
+                }
+                uploadBlocks(view.positions(), view.normals(), view.vertex_count(),
+                             meshletIndices.data(), meshletIndices.size(), mesh.VAO, mesh.VBO, mesh.EBO);
+                mesh.indexCount = (GLsizei)meshletIndices.size();
+            }
+            
+            std::cout << "Loaded " << view.vertex_count() << " vertex and " << view.index_count() << " index for " << name
+                      << " (rmesh, " << view.meshlet_count() << " meshlets)" << std::endl;
+            return true;
+        }
+        
+        bool loadCompressedMesh(const std::string& filename, const std::string& name) {
+            MeshBuffers decoded;
+            if (!read_mesh_compressed(filename, decoded)) {
+                return false;
+            }
+            
+            Mesh& mesh = organs[name];
+            mesh.vertices.clear();
+            mesh.indices.clear();
+            float minBounds[3], maxBounds[3];
+            decoded.compute_bounds(minBounds, maxBounds);
+            setNormalization(mesh, minBounds, maxBounds);
+            
+            uploadBlocks(decoded.positions.data(), decoded.normals.data(), decoded.vertex_count(),
+                         decoded.indices.data(), decoded.indices.size(), mesh.VAO, mesh.VBO, mesh.EBO);
+            
+            mesh.indexCount = (GLsizei)decoded.indices.size();
+            std::cout << "Loaded " << decoded.vertex_count() << " vertex and " << decoded.indices.size() << " index for " << name << " (rcmp)" << std::endl;
+            return true;
+        }
+        
+        bool loadLodMesh(const std::string& filename, const std::string& name) {
+            LodMeshView view;
+            if (!view.open(filename)) {
+                return false;
+            }
+            
+            Mesh& mesh = organs[name];
+            mesh.vertices.clear();
+            mesh.indices.clear();
+            setNormalization(mesh, view.get_header().min_bounds, view.get_header().max_bounds);
+            
+            for (size_t i = 0; i < view.level_count(); i++) {
+                const LodLevelEntry& entry = view.level(i);
+                LodBuffers lod;
+                uploadBlocks(view.positions(i), view.normals(i), (size_t)entry.vertex_count,
+                             view.indices(i), (size_t)entry.index_count, lod.VAO, lod.VBO, lod.EBO);
+                lod.indexCount = (GLsizei)entry.index_count;
+                lod.error = entry.geometric_error;
+                mesh.lods.push_back(lod);
+            }
+            
+            mesh.VAO = mesh.lods[0].VAO;
+            mesh.indexCount = mesh.lods[0].indexCount;
+            std::cout << "Loaded " << view.level_count() << " levels of detail for " << name << " (rlod)" << std::endl;
+            return true;
+        }
+        
+        // Nivel más simple cuyo error proyectado en pantalla no supera un píxel
+        const LodBuffers& selectLod(const Mesh& mesh) const {
+            float distance = std::max(glm::length(cameraPos - mesh.position), 0.01f);
+            float pixelsPerUnit = 800.0f / (2.0f * distance * tan(glm::radians(22.5f)));
+            float worldScale = std::max(mesh.scale.x, std::max(mesh.scale.y, mesh.scale.z)) / mesh.normalizationScale;
+            
+            size_t selected = 0;
+            for (size_t i = 0; i < mesh.lods.size(); i++) {
+                if (mesh.lods[i].error * worldScale * pixelsPerUnit <= 1.0f) {
+                    selected = i;
+                }
+            }
+            return mesh.lods[selected];
+        }
+        
         bool loadOBJ(const std::string& filename, const std::string& name) {
             std::ifstream file(filename);
             if (!file.is_open()) {
@@ -479,6 +651,7 @@ class FrogAnatomyViewer {
             
             glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.EBO);
             glBufferData(GL_ELEMENT_ARRAY_BUFFER, mesh.indices.size() * sizeof(unsigned int), mesh.indices.data(), GL_STATIC_DRAW);
+            mesh.indexCount = (GLsizei)mesh.indices.size();
             
             glEnableVertexAttribArray(0);
             glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
@@ -522,17 +695,60 @@ class FrogAnatomyViewer {
         void renderOrgan(const std::string& name) {
             Mesh& mesh = organs[name];
             
-            if (mesh.vertices.empty()) return;
+            if (mesh.indexCount == 0) return;
             
             glm::mat4 model = glm::mat4(1.0f);
             model = glm::translate(model, mesh.position);
             model = glm::scale(model, mesh.scale);
+            model = model * mesh.normalization;
             
             glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
             glUniform3fv(colorLoc, 1, glm::value_ptr(mesh.color));
             
+            if (!mesh.lods.empty()) {
+                const LodBuffers& lod = selectLod(mesh);
+                glBindVertexArray(lod.VAO);
+                glDrawElements(GL_TRIANGLES, lod.indexCount, GL_UNSIGNED_INT, 0);
+                glBindVertexArray(0);
+                return;
+            }
+            
+            if (!mesh.meshlets.empty()) {
+                drawVisibleMeshlets(mesh, model);
+                return;
+            }
+            
+            glBindVertexArray(mesh.VAO);
+            glDrawElements(GL_TRIANGLES, mesh.indexCount, GL_UNSIGNED_INT, 0);
+            glBindVertexArray(0);
+        }
+        
+        // Descarta en CPU los meshlets que miran completamente hacia atrás usando su cono de normales
+        void drawVisibleMeshlets(const Mesh& mesh, const glm::mat4& model) {
+            glm::vec3 camera = glm::vec3(glm::inverse(model) * glm::vec4(cameraPos, 1.0f));
+            
+            std::vector<GLsizei> counts;
+            std::vector<const void*> offsets;
+            counts.reserve(mesh.meshlets.size());
+            offsets.reserve(mesh.meshlets.size());
+            
+            for (const auto& meshlet : mesh.meshlets) {
+                glm::vec3 direction = meshlet.center - camera;
+                if (glm::dot(direction, meshlet.coneAxis) >= meshlet.coneCutoff * glm::length(direction) + meshlet.radius) {
+                    continue;
+                }
+                // Meshlets contiguos se unen en una sola llamada
+                const void* offset = (const void*)(meshlet.firstIndex * sizeof(uint32_t));
+                if (!counts.empty() && (const char*)offsets.back() + counts.back() * sizeof(uint32_t) == offset) {
+                    counts.back() += meshlet.indexCount;
+                } else {
+                    counts.push_back(meshlet.indexCount);
+                    offsets.push_back(offset);
+                }
+            }
+            
             glBindVertexArray(mesh.VAO);
-            glDrawElements(GL_TRIANGLES, mesh.indices.size(), GL_UNSIGNED_INT, 0);
+            glMultiDrawElements(GL_TRIANGLES, counts.data(), GL_UNSIGNED_INT, offsets.data(), (GLsizei)counts.size());
             glBindVertexArray(0);
         }
         
@@ -656,6 +872,14 @@ class FrogAnatomyViewer {
         void cleanup() {
             for (auto& pair : organs) {
                 Mesh& mesh = pair.second;
+                for (auto& lod : mesh.lods) {
+                    glDeleteVertexArrays(1, &lod.VAO);
+                    glDeleteBuffers(1, &lod.VBO);
+                    glDeleteBuffers(1, &lod.EBO);
+                }
+                if (!mesh.lods.empty()) {
+                    continue;
+                }
                 if (mesh.VAO != 0) {
                     glDeleteVertexArrays(1, &mesh.VAO);
                     glDeleteBuffers(1, &mesh.VBO);
@@ -3,29 +3,394 @@
 #include <iostream>
 #include <fstream>
 #include <vector>
+#include <sstream>
+#include <map>
+#include <algorithm>
 #include <filesystem>
+#include <thread>
 namespace fs = std::filesystem;
 
+std::vector<float> parse_float_list(const std::string& text) {
+    std::vector<float> values;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) {
+            values.push_back(std::stof(item));
+        }
+    }
+    return values;
+}
+
+std::vector<std::string> parse_list(const std::string& text) {
+    std::vector<std::string> items;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+struct ExportSettings {
+    std::vector<std::string> formats = { "obj" };
+    std::vector<float> lod_ratios = { 1.0f, 0.25f, 0.0625f, 0.015625f };
+    int normal_bits = 16;
+    bool meshlets = false;
+};
+
+struct MeshSettings {
+    MeshingMode meshing_mode = MeshingMode::MarchingCubes;
+    NormalMode normal_mode = NormalMode::Face;
+    FieldLayout field_layout = FieldLayout::Linear;
+    float kernel_radius = 3.0f;
+    float adaptive_tolerance = 0.1f;
+    int adaptive_depth = 4;
+    size_t min_component = 0;
+    int smooth_iterations = 0;
+    float decimate_ratio = 1.0f;
+    float max_error = 0.0f;
+    bool optimize = false;
+    bool mapped_storage = false;
+};
+
+void configure_marching(MarchingCubes& marching, const MeshSettings& settings) {
+    marching.set_cache_directory("cache");
+    marching.set_normal_mode(settings.normal_mode);
+    marching.set_meshing_mode(settings.meshing_mode);
+    marching.set_field_layout(settings.field_layout);
+    marching.set_mapped_storage(settings.mapped_storage);
+    marching.set_kernel_radius_factor(settings.kernel_radius);
+    marching.set_adaptive_tolerance(settings.adaptive_tolerance);
+    marching.set_adaptive_depth(settings.adaptive_depth);
+}
+
+// Limpieza, suavizado, simplificación y reordenamiento de cada malla generada
+void process_meshes(MarchingCubes& marching, const MeshSettings& settings) {
+    for (size_t level = 0; level < marching.get_mesh_count(); level++) {
+        // Descartar islas pequeñas producidas por ruido en las máscaras
+        if (settings.min_component > 0) {
+            marching.filter_components(settings.min_component, level);
+        }
+
+        if (settings.smooth_iterations > 0) {
+            marching.smooth_mesh(settings.smooth_iterations, level);
+        }
+
+        if (settings.decimate_ratio < 1.0f || settings.max_error > 0.0f) {
+            SimplificationOptions options;
+            // Sin --decimate solo el error máximo decide cuándo parar
+            if (settings.decimate_ratio < 1.0f) {
+                options.target_triangles = (size_t)(marching.get_mesh(level).triangle_count() * settings.decimate_ratio);
+            }
+            options.max_error = settings.max_error;
+            marching.decimate_mesh(options, level);
+        }
+
+        if (settings.optimize) {
+            marching.optimize_mesh(level);
+        }
+    }
+}
+
+void export_mesh_level(MarchingCubes& marching, const std::string& file_base, size_t level, const ExportSettings& settings) {
+    for (const auto& format : settings.formats) {
+        if (format == "obj") {
+            marching.export_file_obj(file_base + ".obj", level);
+        } else if (format == "ply") {
+            marching.export_file_ply(file_base + ".ply", level);
+        } else if (format == "rmesh") {
+            marching.export_file_native(file_base + ".rmesh", settings.meshlets, level);
+        } else if (format == "rlod") {
+            marching.export_file_lod(file_base + ".rlod", settings.lod_ratios, level);
+        } else if (format == "rcmp") {
+            marching.export_file_compressed(file_base + ".rcmp", settings.normal_bits, level);
+        }
+    }
+    std::cout << "Marching Cubes completed. Mesh exported to: " << file_base << std::endl;
+}
+
+std::string mesh_file_base(const std::string& base_name, float iso_level, size_t level_count) {
+    if (level_count > 1) {
+        std::ostringstream iso_name;
+        iso_name << iso_level;
+        return "mallas/" + base_name + "_iso" + iso_name.str() + "_mesh";
+    }
+    return "mallas/" + base_name + "_mesh";
+}
+
+// Las mallas que ya quedaron en su .rmesh mapeado no se vuelven a exportar
+void export_meshes(MarchingCubes& marching, const std::string& base_name, const ExportSettings& settings) {
+    for (size_t level = 0; level < marching.get_mesh_count(); level++) {
+        if (!marching.get_mapped_file(level).empty()) {
+            std::cout << "Marching Cubes completed. Mesh written to: " << marching.get_mapped_file(level) << std::endl;
+            continue;
+        }
+        std::string file_base = mesh_file_base(base_name, marching.get_iso_level(level), marching.get_mesh_count());
+        export_mesh_level(marching, file_base, level, settings);
+    }
+}
+
+// Una malla por órgano con el nombre que espera el visualizador
+void export_label_meshes(MarchingCubes& marching, const ExportSettings& settings) {
+    for (size_t level = 0; level < marching.get_mesh_count(); level++) {
+        if (marching.get_mesh(level).triangle_count() == 0) {
+            std::cerr << "Label " << marching.get_label(level) << " produced no triangles." << std::endl;
+            continue;
+        }
+        export_mesh_level(marching, "mallas/" + marching.get_label(level) + "_extraction_points_mesh", level, settings);
+    }
+}
+
+// Con --mmap, si solo se pide .rmesh y no hay pasos posteriores, cada malla terminada se escribe a través de
+// su archivo mapeado y no se vuelve a exportar; en otro caso solo el campo usa almacenamiento mapeado
+std::vector<std::string> mapped_output_files(const std::string& base_name, const std::vector<float>& iso_levels,
+                                             const MeshSettings& mesh_settings, const ExportSettings& export_settings) {
+    std::vector<std::string> files;
+    bool post_processing = mesh_settings.min_component > 0 || mesh_settings.smooth_iterations > 0 ||
+                           mesh_settings.decimate_ratio < 1.0f || mesh_settings.max_error > 0.0f || mesh_settings.optimize;
+    if (!mesh_settings.mapped_storage || post_processing || export_settings.meshlets ||
+        export_settings.formats != std::vector<std::string>{ "rmesh" }) {
+        return files;
+    }
+    for (float iso_level : iso_levels) {
+        files.push_back(mesh_file_base(base_name, iso_level, iso_levels.size()) + ".rmesh");
+    }
+    return files;
+}
+
+// Opciones de names presentes en flags que un modo no puede respetar; allowed son los valores que sí admite
+std::vector<std::string> unsupported_flags(const std::map<std::string, std::string>& flags, const std::vector<std::string>& names,
+                                           const std::map<std::string, std::string>& allowed = {}) {
+    std::vector<std::string> unsupported;
+    for (const auto& [name, value] : flags) {
+        auto allowed_value = allowed.find(name);
+        if (allowed_value != allowed.end() && allowed_value->second == value) {
+            continue;
+        }
+        if (std::find(names.begin(), names.end(), name) != names.end()) {
+            unsupported.push_back("--" + name + (value.empty() ? "" : "=" + value));
+        }
+    }
+    return unsupported;
+}
+
+// Informa las opciones rechazadas; devuelve true si no hay ninguna
+bool check_supported_flags(const std::string& mode, const std::string& limitation, const std::vector<std::string>& unsupported) {
+    if (unsupported.empty()) {
+        return true;
+    }
+    std::cerr << "Error: " << mode << " " << limitation << ", unsupported:";
+    for (const auto& flag : unsupported) {
+        std::cerr << " " << flag;
+    }
+    std::cerr << std::endl;
+    return false;
+}
+
+// La generación por bloques une las mallas directamente en un .obj con normales del gradiente:
+// devuelve las opciones que ese camino no puede respetar
+std::vector<std::string> unsupported_chunked_flags(const std::map<std::string, std::string>& flags) {
+    return unsupported_flags(flags,
+                             { "format", "mesher", "normals", "smooth", "decimate", "max-error", "optimize", "min-component",
+                               "meshlets", "lod", "normal-bits", "mmap", "adaptive-error", "adaptive-depth" },
+                             { { "format", "obj" }, { "mesher", "mc" }, { "normals", "gradient" } });
+}
+
+// El modo incremental reutiliza las mallas de Marching Cubes guardadas en cache/ y no escribe salida mapeada
+std::vector<std::string> unsupported_incremental_flags(const std::map<std::string, std::string>& flags) {
+    return unsupported_flags(flags, { "mesher", "mmap", "adaptive-error", "adaptive-depth" }, { { "mesher", "mc" } });
+}
+
+// Las máscaras etiquetadas se recorren con Marching Cubes sobre las etiquetas de los vóxeles: no hay campo
+// escalar ni niveles iso y las normales salen siempre de las caras
+std::vector<std::string> unsupported_label_flags(const std::map<std::string, std::string>& flags) {
+    return unsupported_flags(flags,
+                             { "mesher", "normals", "field-layout", "kernel-radius", "mmap", "adaptive-error", "adaptive-depth" },
+                             { { "mesher", "mc" }, { "normals", "face" }, { "field-layout", "linear" } });
+}
+
+// Borra los contenedores .rchunk intermedios de todos los niveles
+void remove_chunk_files(const std::vector<std::vector<std::string>>& chunk_files) {
+    std::error_code error;
+    for (const auto& level_files : chunk_files) {
+        for (const auto& file : level_files) {
+            fs::remove(file, error);
+        }
+    }
+}
+
+// Lanza un proceso por losa con los mismos argumentos más --slab=i/N y espera a que terminen todos.
+// La salida de cada trabajador se muestra si falla y su log se borra siempre
+bool run_slab_workers(int argc, char* argv[], int workers) {
+    std::string command = "\"" + std::string(argv[0]) + "\"";
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg.rfind("--workers", 0) != 0) {
+            command += " \"" + arg + "\"";
+        }
+    }
+
+    std::vector<int> results(workers, -1);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < workers; i++) {
+        threads.emplace_back([&, i]() {
+            std::string log = "cache/slab" + std::to_string(i) + ".log";
+            std::string worker = command + " --slab=" + std::to_string(i) + "/" + std::to_string(workers) + " > \"" + log + "\" 2>&1";
+            results[i] = std::system(worker.c_str());
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    bool success = true;
+    for (int i = 0; i < workers; i++) {
+        std::string log = "cache/slab" + std::to_string(i) + ".log";
+        if (results[i] != 0) {
+            std::cerr << "Slab worker " << i << " failed:" << std::endl;
+            std::ifstream output(log);
+            std::cerr << output.rdbuf() << std::endl;
+            success = false;
+        }
+        std::error_code error;
+        fs::remove(log, error);
+    }
+    return success;
+}
+
 int main(int argc, char* argv[]) {
-    if (argc < 3) {
+    // Los argumentos "--clave=valor" son opciones, el resto son posicionales
+    std::vector<std::string> args;
+    std::map<std::string, std::string> flags;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg.rfind("--", 0) == 0) {
+            size_t equal = arg.find('=');
+            flags[arg.substr(2, equal - 2)] = equal == std::string::npos ? "" : arg.substr(equal + 1);
+        } else {
+            args.push_back(arg);
+        }
+    }
+
+    if (args.size() < 2) {
         std::cerr << "Usage: " << argv[0] << " <tiff_file | xy<_file> <opcion>" << std::endl;
-        std::cerr << "Options: 1 = Extract points only, 2 = Marching Cubes" << std::endl;
+        std::cerr << "Options: 1 = Extract points only, 2 = Marching Cubes, 3 = Extract points and Marching Cubes in memory, 4 = One mesh per mask of a directory in a single pass" << std::endl;
+        std::cerr << "Option 4 uses cell_size as an integer voxel stride and rejects iso levels, --mesher, --normals, --field-layout, --kernel-radius, --mmap and --adaptive-*" << std::endl;
         std::cerr << "cell_size: Optional parameter for Marching Cubes (default: 0.5)" << std::endl;
+        std::cerr << "iso_levels: Optional comma separated list for Marching Cubes (default: 0.5), e.g. 0.3,0.5,0.8" << std::endl;
+        std::cerr << "--save-points: With option 3, also write the extracted points to coordenadas/" << std::endl;
+        std::cerr << "--incremental: With option 3, re-mesh only the slices that changed since the last run of the same TIFF (Marching Cubes only; --mesher other than mc and --mmap are rejected)" << std::endl;
+        std::cerr << "--mesher=mc|surfacenets|dc|adaptive: Marching Cubes (default), Surface Nets, Dual Contouring or adaptive octree Dual Contouring" << std::endl;
+        std::cerr << "--adaptive-error=cells: Mean plane distance allowed when merging octree cells with --mesher=adaptive (default: 0.1)" << std::endl;
+        std::cerr << "--adaptive-depth=levels: Octree levels of --mesher=adaptive, used to merge cells of up to 2^levels cells per side and to sample the field approximately on the octree; 0 evaluates the full field (default: 4)" << std::endl;
+        std::cerr << "--field-layout=linear|bricked: Scalar field stored by Z layers (default) or in 8x8x8 bricks walked brick by brick" << std::endl;
+        std::cerr << "--normals=face|gradient: Vertex normals from averaged faces (default) or field gradient" << std::endl;
+        std::cerr << "--format=obj,ply,rmesh,rlod,rcmp: Comma separated output formats (default: obj)" << std::endl;
+        std::cerr << "--lod=1,0.25,0.0625,0.015625: Triangle ratios of the levels written to .rlod" << std::endl;
+        std::cerr << "--normal-bits=8|16: Bits per component of the octahedral normals written to .rcmp (default: 16)" << std::endl;
+        std::cerr << "--meshlets: Store meshlets (64 vertices, 124 triangles) with bounding spheres and normal cones in .rmesh" << std::endl;
+        std::cerr << "--min-component=triangles: Discard connected components with fewer triangles" << std::endl;
+        std::cerr << "--kernel-radius=factor: Cutoff radius of the Gaussian kernel in cell sizes (default: 3)" << std::endl;
+        std::cerr << "--smooth=iterations: Taubin smoothing iterations applied to the mesh" << std::endl;
+        std::cerr << "--decimate=ratio: Keep this fraction of triangles with quadric edge collapse, e.g. 0.1" << std::endl;
+        std::cerr << "--max-error=distance: Stop decimation when the collapse error exceeds this distance" << std::endl;
+        std::cerr << "--memory-budget=MB: With option 2, mesh the cloud in Z chunks that fit in this memory and weld them into a streamed .obj (Marching Cubes with gradient normals only; --format other than obj, --mesher, --normals=face, --smooth, --decimate, --optimize, --min-component and --mmap are rejected)" << std::endl;
+        std::cerr << "--workers=N: With option 2, split the Z layers among N local worker processes and weld their partial meshes into .obj (same limitations as --memory-budget)" << std::endl;
+        std::cerr << "--mmap: Compute the scalar field inside its mapped cache file and, with --format=rmesh and no post-processing, write each finished mesh through a mapped .rmesh (the mesh itself is still built in memory)" << std::endl;
+        std::cerr << "--optimize: Reorder triangles and vertices for vertex cache, overdraw and fetch before export" << std::endl;
         return 1;
     }
 
-    std::string filename = argv[1];
-    int option = std::stoi(argv[2]);
+    std::string filename = args[0];
+    int option = std::stoi(args[1]);
     float cell_size = 0.5f;
-    if (argc >= 4) {
-        cell_size = std::stof(argv[3]);
+    if (args.size() >= 3) {
+        cell_size = std::stof(args[2]);
+    }
+    std::vector<float> iso_levels = { 0.5f };
+    if (args.size() >= 4) {
+        iso_levels = parse_float_list(args[3]);
+        if (iso_levels.empty()) {
+            std::cerr << "Error: invalid iso levels: " << args[3] << std::endl;
+            return 1;
+        }
+    }
+    ExportSettings export_settings;
+    if (flags.count("format")) {
+        export_settings.formats = parse_list(flags["format"]);
+        for (const auto& format : export_settings.formats) {
+            if (format != "obj" && format != "ply" && format != "rmesh" && format != "rlod" && format != "rcmp") {
+                std::cerr << "Error: invalid output format: " << format << std::endl;
+                return 1;
+            }
+        }
+    }
+    if (flags.count("lod")) {
+        export_settings.lod_ratios = parse_float_list(flags["lod"]);
+    }
+    export_settings.meshlets = flags.count("meshlets") > 0;
+    if (flags.count("normal-bits")) {
+        export_settings.normal_bits = std::stoi(flags["normal-bits"]);
+        if (export_settings.normal_bits != 8 && export_settings.normal_bits != 16) {
+            std::cerr << "Error: invalid normal bits: " << flags["normal-bits"] << std::endl;
+            return 1;
+        }
+    }
+    MeshSettings mesh_settings;
+    mesh_settings.decimate_ratio = flags.count("decimate") ? std::stof(flags["decimate"]) : 1.0f;
+    mesh_settings.max_error = flags.count("max-error") ? std::stof(flags["max-error"]) : 0.0f;
+    mesh_settings.optimize = flags.count("optimize") > 0;
+    mesh_settings.mapped_storage = flags.count("mmap") > 0;
+    mesh_settings.min_component = flags.count("min-component") ? (size_t)std::stoul(flags["min-component"]) : 0;
+    mesh_settings.smooth_iterations = flags.count("smooth") ? std::stoi(flags["smooth"]) : 0;
+    mesh_settings.kernel_radius = flags.count("kernel-radius") ? std::stof(flags["kernel-radius"]) : 3.0f;
+    mesh_settings.adaptive_tolerance = flags.count("adaptive-error") ? std::stof(flags["adaptive-error"]) : 0.1f;
+    mesh_settings.adaptive_depth = flags.count("adaptive-depth") ? std::stoi(flags["adaptive-depth"]) : 4;
+    if (mesh_settings.adaptive_depth < 0 || mesh_settings.adaptive_depth > 8) {
+        std::cerr << "Error: invalid adaptive depth: " << mesh_settings.adaptive_depth << std::endl;
+        return 1;
+    }
+    if (flags.count("mesher")) {
+        if (flags["mesher"] == "surfacenets") {
+            mesh_settings.meshing_mode = MeshingMode::SurfaceNets;
+        } else if (flags["mesher"] == "dc") {
+            mesh_settings.meshing_mode = MeshingMode::DualContouring;
+        } else if (flags["mesher"] == "adaptive") {
+            mesh_settings.meshing_mode = MeshingMode::Adaptive;
+        } else if (flags["mesher"] != "mc") {
+            std::cerr << "Error: invalid mesher: " << flags["mesher"] << std::endl;
+            return 1;
+        }
     }
+    if (flags.count("field-layout")) {
+        if (flags["field-layout"] == "bricked") {
+            mesh_settings.field_layout = FieldLayout::Bricked;
+        } else if (flags["field-layout"] != "linear") {
+            std::cerr << "Error: invalid field layout: " << flags["field-layout"] << std::endl;
+            return 1;
+        }
+    }
+    if (flags.count("normals")) {
+        if (flags["normals"] == "gradient") {
+            mesh_settings.normal_mode = NormalMode::Gradient;
+        } else if (flags["normals"] != "face") {
+            std::cerr << "Error: invalid normals mode: " << flags["normals"] << std::endl;
+            return 1;
+        }
+    }
+    bool save_points_file = flags.count("save-points") > 0;
+    size_t memory_budget = flags.count("memory-budget") ? (size_t)std::stoul(flags["memory-budget"]) << 20 : 0;
+    int workers = flags.count("workers") ? std::stoi(flags["workers"]) : 1;
     
     std::string extension = fs::path(filename).extension().string();
     std::string base_name = fs::path(filename).stem().string();
 
     system("mkdir coordenadas >nul 2>nul");
     system("mkdir mallas >nul 2>nul");
+    system("mkdir cache >nul 2>nul");
 
     switch(option) {
         case 1: {
@@ -57,23 +422,168 @@ int main(int argc, char* argv[]) {
             
             std::cout << "Processing point cloud: " << filename << std::endl;
             std::cout << "Cell size: " << cell_size << std::endl;
+            std::cout << "Iso levels: " << iso_levels.size() << std::endl;
             
             // Crear instancia de MarchingCubes con el tamaño de celda especificado
             MarchingCubes marching(cell_size);
+            configure_marching(marching, mesh_settings);
+
+            if (flags.count("slab") || memory_budget > 0 || workers > 1) {
+                if (!check_supported_flags(memory_budget > 0 ? "--memory-budget" : "--workers",
+                                           "only supports Marching Cubes with gradient normals written to .obj",
+                                           unsupported_chunked_flags(flags))) {
+                    return 1;
+                }
+            }
+
+            // Modo trabajador: genera solo las capas de su losa y deja el contenedor parcial al coordinador
+            if (flags.count("slab")) {
+                std::string slab = flags["slab"];
+                int slab_index = std::stoi(slab.substr(0, slab.find('/')));
+                int slab_count = std::stoi(slab.substr(slab.find('/') + 1));
+                std::vector<std::string> part_files;
+                for (float iso_level : iso_levels) {
+                    part_files.push_back(mesh_file_base(base_name, iso_level, iso_levels.size()) + ".part" + std::to_string(slab_index) + ".rchunk");
+                }
+                return marching.process_point_cloud_chunked(filename, iso_levels, memory_budget, part_files, slab_index, slab_count) ? 0 : 1;
+            }
+
+            // Con presupuesto de memoria o varios procesos la malla se genera por bloques y se une directamente en un .obj
+            if (memory_budget > 0 || workers > 1) {
+                std::vector<std::vector<std::string>> chunk_files(iso_levels.size());
+                if (workers > 1) {
+                    for (size_t level = 0; level < iso_levels.size(); level++) {
+                        for (int i = 0; i < workers; i++) {
+                            chunk_files[level].push_back(mesh_file_base(base_name, iso_levels[level], iso_levels.size()) + ".part" + std::to_string(i) + ".rchunk");
+                        }
+                    }
+                    std::cout << "Launching " << workers << " slab workers" << std::endl;
+                    if (!run_slab_workers(argc, argv, workers)) {
+                        remove_chunk_files(chunk_files);
+                        return 1;
+                    }
+                } else {
+                    std::vector<std::string> level_files;
+                    for (size_t level = 0; level < iso_levels.size(); level++) {
+                        level_files.push_back(mesh_file_base(base_name, iso_levels[level], iso_levels.size()) + ".rchunk");
+                        chunk_files[level].push_back(level_files.back());
+                    }
+                    if (!marching.process_point_cloud_chunked(filename, iso_levels, memory_budget, level_files)) {
+                        remove_chunk_files(chunk_files);
+                        return 1;
+                    }
+                }
+
+                for (size_t level = 0; level < iso_levels.size(); level++) {
+                    std::string file_obj = mesh_file_base(base_name, iso_levels[level], iso_levels.size()) + ".obj";
+                    if (!weld_chunked_mesh(chunk_files[level], file_obj)) {
+                        remove_chunk_files(chunk_files);
+                        return 1;
+                    }
+                    std::cout << "Marching Cubes completed. Mesh exported to: " << file_obj << std::endl;
+                }
+                remove_chunk_files(chunk_files);
+                break;
+            }
             
             // Procesar la nube de puntos
-            marching.process_point_cloud(filename, cell_size);
+            std::vector<std::string> mapped_files = mapped_output_files(base_name, iso_levels, mesh_settings, export_settings);
+            marching.set_mapped_output(mapped_files);
+            marching.process_point_cloud(filename, iso_levels);
+            process_meshes(marching, mesh_settings);
             
-            // Exportar la malla
-            std::string file_obj = "mallas/" + base_name + "_mesh.obj";
-            marching.export_file_obj(file_obj);
-
-            std::cout << "Marching Cubes completed. Mesh exported to: " << file_obj << std::endl;
+            // Exportar una malla por cada nivel iso
+            export_meshes(marching, base_name, export_settings);
+            break;
+        }
+        
+        case 3: {
+            std::cout << "=== Extraction + Marching Cubes ===" << std::endl;
+            if (extension != ".tif" && extension != ".tiff") {
+                std::cerr << "Error: opción 3 requiere un archivo TIFF (.tif)" << std::endl;
+                return 1;
+            }
+            if (flags.count("incremental") &&
+                !check_supported_flags("--incremental", "only supports Marching Cubes without --mmap", unsupported_incremental_flags(flags))) {
+                return 1;
+            }
+            
+            // Los puntos pasan directamente a MarchingCubes sin archivo intermedio
+            std::vector<Point3D> points = extraction_all_white_points(filename);
+            if (save_points_file) {
+                std::string file_xyz = "coordenadas/" + base_name + "_extraction_points.xyz";
+                if (save_points(file_xyz, points)) {
+                    std::cout << "Extraction points saved to: " << file_xyz << std::endl;
+                }
+            }
+            
+            std::cout << "Cell size: " << cell_size << std::endl;
+            std::cout << "Iso levels: " << iso_levels.size() << std::endl;
+            
+            MarchingCubes marching(cell_size);
+            configure_marching(marching, mesh_settings);
+            if (flags.count("incremental")) {
+                marching.process_points_incremental(points.data(), points.size(), iso_levels, base_name);
+            } else {
+                std::vector<std::string> mapped_files = mapped_output_files(base_name, iso_levels, mesh_settings, export_settings);
+                marching.set_mapped_output(mapped_files);
+                marching.process_points(points.data(), points.size(), iso_levels, base_name);
+            }
+            process_meshes(marching, mesh_settings);
+            
+            export_meshes(marching, base_name, export_settings);
             break;
         }
         
+        case 4: {
+            std::cout << "=== Labeled volume ===" << std::endl;
+            if (!fs::is_directory(filename)) {
+                std::cerr << "Error: Option 4 requires a directory of TIFF masks." << std::endl;
+                return 1;
+            }
+            std::vector<std::string> unsupported = unsupported_label_flags(flags);
+            if (args.size() >= 4) {
+                unsupported.push_back("iso levels " + args[3]);
+            }
+            if (!check_supported_flags("Option 4", "meshes voxel labels with Marching Cubes and face normals", unsupported)) {
+                return 1;
+            }
+
+            // Cada máscara del directorio es una etiqueta; el orden alfabético decide las superposiciones
+            std::vector<std::string> mask_files;
+            for (const auto& entry : fs::directory_iterator(filename)) {
+                std::string mask_extension = entry.path().extension().string();
+                if (entry.is_regular_file() && (mask_extension == ".tif" || mask_extension == ".tiff")) {
+                    mask_files.push_back(entry.path().string());
+                }
+            }
+            std::sort(mask_files.begin(), mask_files.end());
+
+            std::vector<std::string> names;
+            for (const auto& mask_file : mask_files) {
+                names.push_back(fs::path(mask_file).stem().string());
+            }
+
+            LabelVolume volume;
+            if (!extraction_label_volume(mask_files, names, volume)) {
+                return 1;
+            }
+
+            // Con etiquetas el tamaño de celda es un paso entero de muestreo sobre los vóxeles
+            int stride = std::max(1, (int)std::lround(cell_size));
+            std::cout << "Stride: " << stride << std::endl;
+
+            MarchingCubes marching(cell_size);
+            configure_marching(marching, mesh_settings);
+            marching.process_label_volume(volume, stride);
+            process_meshes(marching, mesh_settings);
+
+            export_label_meshes(marching, export_settings);
+            break;
+        }
+
         default:
-            std::cerr << "Invalid option. Use 1 for extraction points or 2 for Marching Cubes." << std::endl;
+            std::cerr << "Invalid option. Use 1 for extraction points, 2 for Marching Cubes, 3 for both or 4 for a directory of masks." << std::endl;
             return 1;
     }
     return 0;